@@ -11,6 +11,14 @@
             # https://github.com/nodejs/node/blob/master/doc/api/n-api.md#n-api-version-matrix
             'defines': ['NAPI_VERSION=4'],
         },
+        {
+            'target_name': 'mi_parser',
+            'sources': ['src/native/mi_parser.cc'],
+            'conditions': [
+                ['OS=="win"', { 'defines': ['NAPI_CPP_EXCEPTIONS'] }],
+            ],
+            'defines': ['NAPI_VERSION=4'],
+        },
     ],
     'target_defaults': {
         # https://github.com/nodejs/node-addon-api/blob/master/doc/setup.md#installation-and-usage
@@ -9,7 +9,10 @@
  *********************************************************************/
 import { spawn, ChildProcess } from 'child_process';
 import * as events from 'events';
-import { Writable } from 'stream';
+import { promises as fs } from 'fs';
+import * as path from 'path';
+import { performance } from 'perf_hooks';
+import { Readable, Writable } from 'stream';
 import { logger } from '@vscode/debugadapter/lib/logger';
 import {
     AttachRequestArguments,
@@ -17,8 +20,32 @@ import {
 } from './GDBDebugSession';
 import * as mi from './mi';
 import { MIResponse } from './mi';
-import { MIParser } from './MIParser';
-import { VarManager } from './varManager';
+import { MIParser, MIResultOptions } from './MIParser';
+import { CommandStats } from './commandTable';
+import {
+    cancelledError,
+    commandPriority,
+    CommandPriority,
+    CommandScheduler,
+    RequestContext,
+    requestContext,
+    ScheduledCommand,
+} from './commandScheduler';
+import { SingleFlight } from './singleFlight';
+import { MITrace } from './miTrace';
+import { probeCache } from './gdbProbeCache';
+import { gdbPool } from './gdbPool';
+import {
+    defaultIndexCacheDir,
+    generateIndex,
+    indexCacheCommand,
+    indexCacheFile,
+    readSymbolIndexInfo,
+    SymbolLoadHistory,
+    SymbolLoadTimes,
+} from './indexCache';
+import { mayChangeValues, VarManager } from './varManager';
+import { ChildPipes } from './native/pipe';
 import {
     compareVersions,
     getGdbVersion,
@@ -37,6 +64,51 @@ export interface MIGDBShowResponse extends MIResponse {
     value?: string;
 }
 
+export interface MICommandOptions extends MIResultOptions {
+    /** Fail the command if its result takes longer, in ms */
+    timeout?: number;
+    /** Defaults to run control for -exec commands, interactive otherwise */
+    priority?: CommandPriority;
+}
+
+export interface MICommandStats extends CommandStats {
+    /** Read-only commands that shared the result of an identical one */
+    shared: number;
+    /** The proportion of read-only commands that were shared */
+    sharedRate: number;
+    /** Commands waiting to be written to gdb */
+    queued: number;
+    /** Commands dropped because their request was cancelled */
+    cancelled: number;
+    /** Times the program stopped */
+    stops: number;
+    /** Mean number of commands sent while the program was stopped */
+    commandsPerStop: number;
+    /** -var-update commands sent, once per stop and after value changes */
+    varUpdates: number;
+    /** Varobjs in gdb, created by the adapter or listed as children */
+    varobjs: number;
+    /** Frames that have varobjs */
+    varFrames: number;
+    /** Varobjs deleted with the least recently used frames */
+    varEvictions: number;
+}
+
+interface IndexCacheOptions {
+    directory: string;
+    /** Index the programs without an index in the background */
+    generate: boolean;
+    gdbPath: string;
+    cwd: string;
+    env: NodeJS.ProcessEnv;
+}
+
+/** The outcome of one of the commands sent with sendPipelined */
+export interface MICommandResult<T> {
+    result?: T;
+    error?: Error;
+}
+
 export declare interface GDBBackend {
     on(
         event: 'consoleStreamOutput',
@@ -59,30 +131,152 @@ export declare interface GDBBackend {
     ): boolean;
 }
 
+/**
+ * The error for a failed command, with the stack of origin if there is one.
+ */
+function commandError(message: string, origin?: Error) {
+    if (!origin) {
+        return new Error(message);
+    }
+    origin.message = message;
+    return origin;
+}
+
 export class GDBBackend extends events.EventEmitter {
+    /** Tracing of the MI traffic, shared with the parser */
+    public readonly tracer = new MITrace();
     protected parser = new MIParser(this);
     protected varMgr = new VarManager(this);
     protected out?: Writable;
+    // what gdb writes, for the parser
+    protected reader?: Readable;
     protected token = 0;
     protected proc?: ChildProcess;
-    private gdbVersion?: string;
+    protected gdbVersion?: string;
     protected gdbAsync = false;
     protected gdbNonStop = false;
+    // the result of -list-features
+    protected gdbFeatures: string[] = [];
+    protected indexCache?: IndexCacheOptions;
+    protected symbolLoadHistory = new SymbolLoadHistory();
+    // the symbol load times of the programs loaded by this backend
+    protected symbolLoads: Record<string, SymbolLoadTimes> = {};
     protected hardwareBreakpoint = false;
+    /** Default timeout of commands in ms, 0 for none */
+    public commandTimeout = 0;
+    /**
+     * Capture the stack where each command is sent from, for the errors
+     * of failed commands. This costs a stack trace per command.
+     */
+    public captureCommandStacks = false;
+    protected singleFlight = new SingleFlight();
+    protected scheduler = new CommandScheduler();
+    /**
+     * How many commands are written to gdb before their results arrive.
+     * The others wait in the scheduler, where more urgent commands can
+     * overtake them.
+     */
+    public maxCommandsInFlight = 8;
+    // commands written to gdb that have no result yet
+    protected inFlight = 0;
+    // nesting of pipeline(), commands are held until it returns
+    protected holding = 0;
+    protected held: ScheduledCommand[] = [];
+    // removes the listeners of the gdb process, see watchProcess
+    protected unwatch?: () => void;
+    // the program stopped and did not resume since
+    protected stopped = false;
+    protected stops = 0;
+    // commands written while the program was stopped
+    protected stoppedCommands = 0;
+
+    constructor() {
+        super();
+        // what read-only commands return may have changed
+        this.on('execAsync', (execClass: string) => {
+            this.singleFlight.clear();
+            this.varMgr.invalidate();
+            if (execClass === 'stopped') {
+                this.stops++;
+                this.stopped = true;
+                this.varMgr.programStopped();
+            } else if (execClass === 'running') {
+                this.stopped = false;
+            }
+        });
+        this.on('notifyAsync', (notifyClass: string, notifyData: any) => {
+            if (notifyClass.startsWith('thread-')) {
+                this.singleFlight.clear();
+            }
+            if (notifyClass === 'thread-exited') {
+                const threadId = parseInt(notifyData.id, 10);
+                this.varMgr
+                    .removeThread(threadId)
+                    .catch((err) =>
+                        logger.warn(
+                            `Could not delete the varobjs of thread ${threadId}: ${err}`
+                        )
+                    );
+            }
+        });
+    }
 
     get varManager(): VarManager {
         return this.varMgr;
     }
 
+    /**
+     * Start gdb, or claim an idle one from the pool when the gdbPoolSize
+     * launch argument enables it.
+     */
     public async spawn(
         requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ) {
+        const start = performance.now();
+        if (requestArgs.varobjLimit !== undefined) {
+            this.varMgr.limit = requestArgs.varobjLimit;
+        }
+        // a recording has to start with gdb, a pooled one started earlier
+        const usePool = !!requestArgs.gdbPoolSize && !requestArgs.recordMI;
+        const warm = usePool ? await gdbPool.claim(requestArgs) : undefined;
+        if (warm) {
+            this.adopt(warm, requestArgs);
+        } else {
+            await this.spawnGdb(requestArgs);
+        }
+        if (usePool) {
+            const time = performance.now() - start;
+            gdbPool.recordLaunch(!!warm, time);
+            logger.verbose(
+                `GDB ready in ${time.toFixed(1)} ms (${
+                    warm ? 'pooled' : 'cold start'
+                })`
+            );
+            gdbPool.fill(
+                requestArgs,
+                requestArgs.gdbPoolSize ?? 0,
+                () => new GDBBackend()
+            );
+        }
+    }
+
+    protected async spawnGdb(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
     ) {
         const gdbPath = requestArgs.gdb || 'gdb';
         this.gdbVersion = await getGdbVersion(
             gdbPath,
             getGdbCwd(requestArgs),
-            requestArgs.environment
+            requestArgs.environment,
+            probeCache(requestArgs.gdbProbeCache)
         );
+        if (requestArgs.recordMI) {
+            this.tracer.startRecording(requestArgs.recordMI, {
+                gdbVersion: this.gdbVersion,
+                gdbNonStop: requestArgs.gdbNonStop,
+                gdbAsync: requestArgs.gdbAsync,
+            });
+        }
         let args = ['--interpreter=mi2'];
         if (requestArgs.gdbArguments) {
             args = args.concat(requestArgs.gdbArguments);
@@ -90,24 +284,174 @@ export class GDBBackend extends events.EventEmitter {
         const gdbEnvironment = requestArgs.environment
             ? createEnvValues(process.env, requestArgs.environment)
             : process.env;
-        this.proc = spawn(gdbPath, args, {
-            cwd: getGdbCwd(requestArgs),
-            env: gdbEnvironment,
-        });
-        if (this.proc.stdin == null || this.proc.stdout == null) {
-            throw new Error('Spawned GDB does not have stdout or stdin');
+        const pipes = requestArgs.gdbPipeSize
+            ? this.createPipes(requestArgs.gdbPipeSize)
+            : undefined;
+        // gdb's output is not part of the request that started it
+        this.proc = requestContext.exit(() =>
+            spawn(gdbPath, args, {
+                cwd: getGdbCwd(requestArgs),
+                env: gdbEnvironment,
+                stdio: pipes
+                    ? [pipes.stdio[0], pipes.stdio[1], 'pipe']
+                    : 'pipe',
+            })
+        );
+        let reader: Readable;
+        if (pipes) {
+            this.watchPipes(this.proc, pipes);
+            this.out = pipes.stdin.writer;
+            reader = pipes.stdout.reader;
+        } else {
+            if (this.proc.stdin == null || this.proc.stdout == null) {
+                throw new Error('Spawned GDB does not have stdout or stdin');
+            }
+            this.out = this.proc.stdin;
+            reader = this.proc.stdout;
         }
-        this.out = this.proc.stdin;
+        this.reader = reader;
+        this.watchProcess(this.proc, reader);
         this.hardwareBreakpoint = requestArgs.hardwareBreakpoint ? true : false;
-        await this.parser.parse(this.proc.stdout);
-        if (this.proc.stderr) {
-            this.proc.stderr.on('data', (chunk) => {
-                const newChunk = chunk.toString();
-                this.emit('consoleStreamOutput', newChunk, 'stderr');
-            });
-        }
+        await this.parser.parse(reader);
         await this.setNonStopMode(requestArgs.gdbNonStop);
         await this.setAsyncMode(requestArgs.gdbAsync);
+        await this.probeFeatures(requestArgs);
+        this.indexCache = this.indexCacheOptions(requestArgs);
+        if (this.indexCache && this.gdbVersion) {
+            const commands = [
+                indexCacheCommand(this.gdbVersion),
+                `set index-cache directory ${this.indexCache.directory}`,
+            ];
+            await this.pipeline(() =>
+                Promise.all(
+                    commands.map((command) => this.sendCommand(command))
+                )
+            );
+        }
+    }
+
+    /**
+     * Pipes to gdb of the given size, so that gdb writes large records, and
+     * the adapter large commands, without waiting for the other side to
+     * drain the default 64 KB pipes.
+     */
+    protected createPipes(size: number): ChildPipes | undefined {
+        try {
+            const pipes = new ChildPipes(size);
+            logger.verbose(`GDB pipe size: ${pipes.size} bytes`);
+            return pipes;
+        } catch (err) {
+            logger.verbose(
+                `Could not create the GDB pipes: ${
+                    err instanceof Error ? err.message : String(err)
+                }`
+            );
+            return undefined;
+        }
+    }
+
+    /** Close the ends of the pipes this process holds along with gdb */
+    protected watchPipes(proc: ChildProcess, pipes: ChildPipes) {
+        // gdb has its own copies, its exit ends the output
+        pipes.closeChildEnds();
+        const closeInput = () => pipes.stdin.destroy();
+        proc.once('exit', closeInput);
+        proc.once('error', closeInput);
+        pipes.stdout.reader.once('end', () => pipes.stdout.destroy());
+    }
+
+    protected indexCacheOptions(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ): IndexCacheOptions | undefined {
+        if (!requestArgs.indexCache) {
+            return undefined;
+        }
+        if (!this.gdbVersionAtLeast('8.3')) {
+            logger.warn('cdt-gdb-adapter: indexCache needs gdb 8.3 or newer');
+            return undefined;
+        }
+        return {
+            directory:
+                typeof requestArgs.indexCache === 'string'
+                    ? requestArgs.indexCache
+                    : defaultIndexCacheDir(),
+            generate: !!requestArgs.generateIndex,
+            gdbPath: requestArgs.gdb || 'gdb',
+            cwd: getGdbCwd(requestArgs),
+            env: requestArgs.environment
+                ? createEnvValues(process.env, requestArgs.environment)
+                : process.env,
+        };
+    }
+
+    protected watchProcess(proc: ChildProcess, reader: Readable) {
+        // after the exit, once the output has been read
+        const onEnd = () => this.tracer.stopRecording();
+        const onClose = () =>
+            reader.readableEnded ? onEnd() : reader.once('end', onEnd);
+        const onExit = (code: number | null, signal: string | null) => {
+            if (code || signal) {
+                this.tracer.dumpToLog(
+                    `GDB exited unexpectedly (${signal || code})`
+                );
+            }
+        };
+        const onStderr = (chunk: Buffer) => {
+            this.emit('consoleStreamOutput', chunk.toString(), 'stderr');
+        };
+        proc.on('close', onClose);
+        proc.on('exit', onExit);
+        proc.stderr?.on('data', onStderr);
+        this.unwatch = () => {
+            proc.off('close', onClose);
+            proc.off('exit', onExit);
+            proc.stderr?.off('data', onStderr);
+            reader.off('end', onEnd);
+            this.parser.stopListening(reader);
+        };
+    }
+
+    /**
+     * Take over the configured gdb of a pooled backend.
+     */
+    protected adopt(
+        warm: GDBBackend,
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ) {
+        const proc = warm.proc;
+        const reader = warm.reader;
+        if (!proc || !reader) {
+            throw new Error('Pooled GDB is not running');
+        }
+        warm.unwatch?.();
+        warm.proc = undefined;
+        warm.reader = undefined;
+        this.proc = proc;
+        this.out = warm.out;
+        this.reader = reader;
+        this.token = warm.token;
+        this.gdbVersion = warm.gdbVersion;
+        this.gdbNonStop = warm.gdbNonStop;
+        this.gdbAsync = warm.gdbAsync;
+        this.gdbFeatures = warm.gdbFeatures;
+        // the pooled gdb was started with the same index cache
+        this.indexCache = this.indexCacheOptions(requestArgs);
+        this.hardwareBreakpoint = requestArgs.hardwareBreakpoint ? true : false;
+        this.watchProcess(proc, reader);
+        this.parser.listen(reader);
+    }
+
+    public isExited(): boolean {
+        return (
+            !this.proc ||
+            this.proc.exitCode !== null ||
+            this.proc.signalCode !== null
+        );
+    }
+
+    /** Stop gdb without asking it to exit */
+    public kill() {
+        this.proc?.kill();
     }
 
     public async spawnInClientTerminal(
@@ -118,12 +462,20 @@ export class GDBBackend extends events.EventEmitter {
         this.gdbVersion = await getGdbVersion(
             gdbPath,
             getGdbCwd(requestArgs),
-            requestArgs.environment
+            requestArgs.environment,
+            probeCache(requestArgs.gdbProbeCache)
         );
+        if (requestArgs.recordMI) {
+            this.tracer.startRecording(requestArgs.recordMI, {
+                gdbVersion: this.gdbVersion,
+                gdbNonStop: requestArgs.gdbNonStop,
+                gdbAsync: requestArgs.gdbAsync,
+            });
+        }
         // Use dynamic import to remove need for natively building this adapter
         // Useful when 'spawnInClientTerminal' isn't needed, but adapter is distributed on multiple OS's
         const { Pty } = await import('./native/pty');
-        const pty = new Pty();
+        const pty = requestContext.exit(() => new Pty());
         let args = [gdbPath, '-ex', `new-ui mi2 ${pty.slave_name}`];
         if (requestArgs.gdbArguments) {
             args = args.concat(requestArgs.gdbArguments);
@@ -133,6 +485,7 @@ export class GDBBackend extends events.EventEmitter {
         await this.parser.parse(pty.reader);
         await this.setNonStopMode(requestArgs.gdbNonStop);
         await this.setAsyncMode(requestArgs.gdbAsync);
+        await this.probeFeatures(requestArgs);
     }
 
     public async setAsyncMode(isSet?: boolean) {
@@ -159,6 +512,49 @@ export class GDBBackend extends events.EventEmitter {
         }
     }
 
+    /**
+     * Learn what gdb supports from the probe cache, asking the running gdb
+     * only the first time this gdb executable is used.
+     */
+    protected async probeFeatures(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ) {
+        const gdbPath = requestArgs.gdb || 'gdb';
+        const gdbCwd = getGdbCwd(requestArgs);
+        const gdbEnvironment = requestArgs.environment
+            ? createEnvValues(process.env, requestArgs.environment)
+            : process.env;
+        const cache = probeCache(requestArgs.gdbProbeCache);
+        const probe = await cache?.lookup(gdbPath, gdbCwd, gdbEnvironment);
+        if (probe?.features) {
+            this.gdbFeatures = probe.features;
+            return;
+        }
+        try {
+            const result = await this.sendCommand<{ features?: string[] }>(
+                '-list-features'
+            );
+            this.gdbFeatures = result.features ?? [];
+        } catch {
+            // too old to tell
+            this.gdbFeatures = [];
+            return;
+        }
+        await cache?.store(gdbPath, gdbCwd, gdbEnvironment, {
+            features: this.gdbFeatures,
+            python: this.gdbFeatures.indexOf('python') !== -1,
+        });
+    }
+
+    /** Whether -list-features reported feature */
+    public hasFeature(feature: string): boolean {
+        return this.gdbFeatures.indexOf(feature) !== -1;
+    }
+
+    public hasPython(): boolean {
+        return this.hasFeature('python');
+    }
+
     public getAsyncMode(): boolean {
         return this.gdbAsync;
     }
@@ -218,12 +614,14 @@ export class GDBBackend extends events.EventEmitter {
     public async supportsNewUi(
         gdbPath?: string,
         gdbCwd?: string,
-        environment?: Record<string, string | null>
+        environment?: Record<string, string | null>,
+        useProbeCache?: boolean
     ): Promise<boolean> {
         this.gdbVersion = await getGdbVersion(
             gdbPath || 'gdb',
             gdbCwd,
-            environment
+            environment,
+            probeCache(useProbeCache)
         );
         return this.gdbVersionAtLeast('7.12');
     }
@@ -235,6 +633,14 @@ export class GDBBackend extends events.EventEmitter {
         return compareVersions(this.gdbVersion, targetVersion) >= 0;
     }
 
+    /**
+     * Send the commands one at a time, each once the previous one
+     * succeeded, as for the commands of the user's configuration. Use
+     * sendPipelined for commands that do not depend on each other.
+     *
+     * @throws the error of the command that failed, the next ones are not
+     * sent
+     */
     public async sendCommands(commands?: string[]) {
         if (commands) {
             for (const command of commands) {
@@ -243,43 +649,246 @@ export class GDBBackend extends events.EventEmitter {
         }
     }
 
-    public sendCommand<T>(command: string): Promise<T> {
-        const token = this.nextToken();
-        logger.verbose(`GDB command: ${token} ${command}`);
+    /**
+     * Write everything send() sends to gdb at once, when it returns.
+     *
+     * gdb reads and runs the commands in order, so commands that do not
+     * need the result of the previous ones can be sent together to save
+     * the round trips.
+     */
+    public pipeline<T>(send: () => T): T {
+        this.holding++;
+        try {
+            return send();
+        } finally {
+            this.holding--;
+            if (!this.holding) {
+                this.queueHeld();
+            }
+            this.writeCommands();
+        }
+    }
+
+    /**
+     * Queue the commands of a pipeline at the priority of the most urgent
+     * one, so that they are written in the order they were sent. Only
+     * independent commands are reordered by priority.
+     */
+    protected queueHeld() {
+        const held = this.held;
+        this.held = [];
+        let priority = CommandPriority.Background;
+        for (const command of held) {
+            priority = Math.min(priority, command.priority);
+        }
+        for (const command of held) {
+            command.priority = priority;
+            this.scheduler.push(command);
+        }
+    }
+
+    /**
+     * Send a batch of independent commands in one write.
+     *
+     * @returns the result or the error of each command, in order
+     */
+    public sendPipelined<T = any>(
+        commands: string[]
+    ): Promise<Array<MICommandResult<T>>> {
+        const results = this.pipeline(() =>
+            commands.map((command) =>
+                this.sendCommand<T>(command).then(
+                    (result): MICommandResult<T> => ({ result }),
+                    (error: Error): MICommandResult<T> => ({ error })
+                )
+            )
+        );
+        return Promise.all(results);
+    }
+
+    /**
+     * Send a command to gdb.
+     *
+     * Read-only commands that are identical to one still waiting for its
+     * result get the same result, without sending them again.
+     */
+    public sendCommand<T>(
+        command: string,
+        options?: MICommandOptions
+    ): Promise<T> {
+        if (mayChangeValues(command)) {
+            this.varMgr.invalidate();
+        }
+        const send = () => this.sendMICommand<T>(command, options);
+        // shared commands are sent on behalf of all the requests sharing them
+        return this.singleFlight.run(
+            command,
+            options,
+            (request) =>
+                request
+                    ? requestContext.run(request, send)
+                    : requestContext.exit(send),
+            requestContext.getStore()
+        );
+    }
+
+    /**
+     * Queue a command to be written to gdb, in the order of its priority,
+     * or hold it with the rest of its pipeline, see queueHeld.
+     * A command sent while handling a DAP request belongs to it and is
+     * dropped if the request is cancelled before the command is written.
+     */
+    protected sendMICommand<T>(
+        command: string,
+        options?: MICommandOptions
+    ): Promise<T> {
         return new Promise<T>((resolve, reject) => {
-            if (this.out) {
-                /* Set error to capture the stack where the request originated,
-                   not the stack of reading the stream and parsing the message.
-                */
-                const failure = new Error();
-                this.parser.queueCommand(token, (resultClass, resultData) => {
-                    switch (resultClass) {
-                        case 'done':
-                        case 'running':
-                        case 'connected':
-                        case 'exit':
-                            resolve(resultData);
-                            break;
-                        case 'error':
-                            failure.message = resultData.msg;
-                            reject(failure);
-                            break;
-                        default:
-                            failure.message = `Unknown response ${resultClass}: ${JSON.stringify(
-                                resultData
-                            )}`;
-                            reject(failure);
-                    }
-                });
-                this.out.write(`${token}${command}\n`);
-            } else {
+            if (!this.out) {
                 reject(new Error('gdb is not running.'));
+                return;
+            }
+            const request = requestContext.getStore();
+            if (request?.cancelled) {
+                reject(cancelledError());
+                return;
+            }
+            /* Capture the stack where the request originated, not the
+               stack of reading the stream and parsing the message.
+            */
+            const origin = this.captureCommandStacks ? new Error() : undefined;
+            const scheduled: ScheduledCommand = {
+                command,
+                priority: options?.priority ?? commandPriority(command),
+                request,
+                send: () =>
+                    this.writeCommand(command, options, (error, result) => {
+                        if (error) {
+                            reject(commandError(error, origin));
+                        } else {
+                            resolve(result);
+                        }
+                    }),
+                drop: reject,
+            };
+            if (this.holding) {
+                this.held.push(scheduled);
+            } else {
+                this.scheduler.push(scheduled);
+                this.writeCommands();
             }
         });
     }
 
-    public sendEnablePrettyPrint() {
-        return this.sendCommand('-enable-pretty-printing');
+    /**
+     * Write the most urgent queued commands, as many as can be in flight.
+     */
+    protected writeCommands() {
+        const out = this.out;
+        if (
+            !out ||
+            this.holding ||
+            !this.scheduler.size ||
+            this.inFlight >= this.maxCommandsInFlight
+        ) {
+            return;
+        }
+        out.cork();
+        try {
+            while (this.inFlight < this.maxCommandsInFlight) {
+                const next = this.scheduler.shift();
+                if (!next) {
+                    break;
+                }
+                this.inFlight++;
+                next.send();
+            }
+        } finally {
+            out.uncork();
+        }
+    }
+
+    protected writeCommand(
+        command: string,
+        options: MICommandOptions | undefined,
+        done: (error: string | undefined, result?: any) => void
+    ) {
+        const token = this.nextToken();
+        if (this.stopped) {
+            this.stoppedCommands++;
+        }
+        if (this.tracer.enabled) {
+            this.tracer.traceOut(token, command);
+        }
+        const pending = this.parser.queueCommand(
+            token,
+            (resultClass, resultData) => {
+                this.inFlight--;
+                switch (resultClass) {
+                    case 'done':
+                    case 'running':
+                    case 'connected':
+                    case 'exit':
+                        done(undefined, resultData);
+                        break;
+                    case 'error':
+                        done(resultData.msg);
+                        break;
+                    default: {
+                        const message = `Unknown response ${resultClass}: ${JSON.stringify(
+                            resultData
+                        )}`;
+                        this.tracer.dumpToLog(message);
+                        done(message);
+                    }
+                }
+                this.writeCommands();
+            },
+            options
+        );
+        pending.command = command;
+        const timeout = options?.timeout ?? this.commandTimeout;
+        if (timeout > 0) {
+            this.parser.setCommandTimeout(pending, timeout);
+        }
+        this.out?.write(`${token}${command}\n`);
+    }
+
+    /**
+     * Drop the commands of a cancelled DAP request that are not written to
+     * gdb yet. The commands it sends from now on fail too.
+     *
+     * @returns how many commands were dropped
+     */
+    public cancelCommands(request: RequestContext): number {
+        request.cancelled = true;
+        return this.scheduler.cancel(request);
+    }
+
+    /**
+     * Counts and timings of the commands sent to gdb.
+     */
+    public getCommandStats(): MICommandStats {
+        return {
+            ...this.parser.getCommandStats(),
+            shared: this.singleFlight.shared,
+            sharedRate: this.singleFlight.hitRate,
+            queued: this.scheduler.size,
+            cancelled: this.scheduler.cancelled,
+            stops: this.stops,
+            commandsPerStop: this.stops ? this.stoppedCommands / this.stops : 0,
+            varUpdates: this.varMgr.updates,
+            varobjs: this.varMgr.size,
+            varFrames: this.varMgr.frames,
+            varEvictions: this.varMgr.evicted,
+        };
+    }
+
+    public async sendEnablePrettyPrint() {
+        // pretty printers are written in Python, unknown features may have it
+        if (this.gdbFeatures.length && !this.hasPython()) {
+            return;
+        }
+        await this.sendCommand('-enable-pretty-printing');
     }
 
     // Rewrite the argument escaping whitespace, quotes and backslash
@@ -301,9 +910,83 @@ export class GDBBackend extends events.EventEmitter {
     }
 
     public sendFileExecAndSymbols(program: string) {
-        return this.sendCommand(
+        const loading = this.sendCommand(
             `-file-exec-and-symbols ${this.standardEscape(program)}`
         );
+        if (this.indexCache) {
+            this.timeSymbolLoad(program, this.indexCache, loading);
+        }
+        return loading;
+    }
+
+    /**
+     * Time loading the symbols of program, telling the loads where gdb
+     * had an index, warm, from the others, cold. A program that has no
+     * index gets one generated in the background if the launch asked for
+     * it.
+     */
+    protected async timeSymbolLoad(
+        program: string,
+        indexCache: IndexCacheOptions,
+        loading: Promise<unknown>
+    ) {
+        const start = performance.now();
+        const file = path.resolve(indexCache.cwd, program);
+        let warm: boolean | undefined;
+        try {
+            // before gdb writes the index cache
+            const info = await readSymbolIndexInfo(file);
+            if (info) {
+                const cached = info.buildId
+                    ? indexCacheFile(indexCache.directory, info.buildId)
+                    : undefined;
+                warm =
+                    info.hasIndex ||
+                    (cached !== undefined &&
+                        (await fs.access(cached).then(
+                            () => true,
+                            () => false
+                        )));
+                if (
+                    !warm &&
+                    indexCache.generate &&
+                    info.buildId &&
+                    this.gdbVersion
+                ) {
+                    generateIndex(
+                        indexCache.gdbPath,
+                        this.gdbVersion,
+                        file,
+                        indexCache.directory,
+                        info.buildId,
+                        { cwd: indexCache.cwd, env: indexCache.env }
+                    );
+                }
+            }
+            await loading;
+        } catch {
+            // the program could not be loaded, the caller reports it
+            return;
+        }
+        const time = Math.round(performance.now() - start);
+        if (warm === undefined) {
+            logger.verbose(`Loaded the symbols of ${file} in ${time} ms`);
+            return;
+        }
+        const times = await this.symbolLoadHistory.record(file, warm, time);
+        this.symbolLoads[file] = times;
+        logger.verbose(
+            `Loaded the symbols of ${file} in ${time} ms (${
+                warm ? 'warm' : 'cold'
+            }), last cold load ${times.cold ?? '-'} ms, last warm load ${
+                times.warm ?? '-'
+            } ms`
+        );
+    }
+
+    /** The last cold and warm symbol load times of the programs loaded */
+    public getSymbolLoads(): Record<string, SymbolLoadTimes> {
+        return this.symbolLoads;
     }
 
     public sendFileSymbolFile(symbols: string) {
@@ -332,8 +1015,12 @@ export class GDBBackend extends events.EventEmitter {
         return this.sendCommand(`-gdb-show ${params}`);
     }
 
-    public sendGDBExit() {
-        return this.sendCommand('-gdb-exit');
+    public async sendGDBExit() {
+        try {
+            return await this.sendCommand('-gdb-exit');
+        } finally {
+            this.tracer.stopRecording();
+        }
     }
 
     protected nextToken() {
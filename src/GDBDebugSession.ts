@@ -18,6 +18,8 @@ import {
     logger,
     LoggingDebugSession,
     OutputEvent,
+    ProgressEndEvent,
+    ProgressStartEvent,
     Response,
     Scope,
     Source,
@@ -25,16 +27,21 @@ import {
     TerminatedEvent,
 } from '@vscode/debugadapter';
 import { DebugProtocol } from '@vscode/debugprotocol';
-import { GDBBackend } from './GDBBackend';
+import { GDBBackend, MICommandStats } from './GDBBackend';
 import * as mi from './mi';
 import {
-    sendDataReadMemoryBytes,
+    sendDataReadMemoryBytesAsBuffer,
     sendDataDisassemble,
     sendDataWriteMemoryBytes,
 } from './mi/data';
 import { StoppedEvent } from './stoppedEvent';
 import { VarObjType } from './varManager';
-import { createEnvValues, getGdbCwd } from './util';
+import { createEnvValues, excerpt, getGdbCwd } from './util';
+import { OutputAggregator } from './outputAggregator';
+import { RequestContext, requestContext } from './commandScheduler';
+import { gdbPool, GDBPoolStats } from './gdbPool';
+import { SymbolLoadTimes } from './indexCache';
+import { loadNativeMIParser } from './native/mi-parser';
 
 export interface RequestArguments extends DebugProtocol.LaunchRequestArguments {
     gdb?: string;
@@ -51,6 +58,28 @@ export interface RequestArguments extends DebugProtocol.LaunchRequestArguments {
     openGdbConsole?: boolean;
     initCommands?: string[];
     hardwareBreakpoint?: boolean;
+    // characters of console output merged into one output event, 0 to send each line on its own
+    outputFlushThreshold?: number;
+    // bytes of the most recent MI traffic kept in memory and dumped on errors, 0 to disable
+    miTraceBufferSize?: number;
+    // file where the MI traffic of the session is recorded, for MIReplayBackend
+    recordMI?: string;
+    // milliseconds after which gdb commands fail if they have no result, 0 for no timeout
+    commandTimeout?: number;
+    // keep the stack of where each gdb command was sent from, for the errors of failed commands
+    captureCommandStacks?: boolean;
+    // keep this many gdbs started and configured for the next launches with the same gdb, cwd and environment
+    gdbPoolSize?: number;
+    // load symbols with gdb's index cache, in this directory or in gdb's default one if true
+    indexCache?: boolean | string;
+    // with indexCache, index the programs that have no index with a gdb in the background
+    generateIndex?: boolean;
+    // size in bytes of the pipes to gdb (Linux only), for large records
+    gdbPipeSize?: number;
+    // most varobjs kept in gdb, the least recently used frames lose theirs beyond it, 0 for no limit
+    varobjLimit?: number;
+    // remember what each gdb supports in the user's cache directory, true by default
+    gdbProbeCache?: boolean;
 }
 
 export interface LaunchRequestArguments extends RequestArguments {
@@ -64,6 +93,8 @@ export interface AttachRequestArguments extends RequestArguments {
 export interface FrameReference {
     threadId: number;
     frameId: number;
+    /** Identity of the frame for its varobjs, see frameKey */
+    key?: string;
 }
 
 export interface FrameVariableReference {
@@ -107,6 +138,28 @@ export interface MemoryResponse extends Response {
     body: MemoryContents;
 }
 
+/**
+ * Response for our custom 'cdt-gdb-adapter/Stats' request.
+ */
+export interface StatsResponse extends Response {
+    body: {
+        commands: MICommandStats;
+        pool: GDBPoolStats;
+        /** The last cold and warm symbol load times, by program */
+        symbols: Record<string, SymbolLoadTimes>;
+    };
+}
+
+/**
+ * Response for our custom 'cdt-gdb-adapter/MITrace' request.
+ */
+export interface MITraceResponse extends Response {
+    body: {
+        /* The recorded MI traffic, oldest first. */
+        trace: string[];
+    };
+}
+
 export interface CDTDisassembleArguments
     extends DebugProtocol.DisassembleArguments {
     /**
@@ -135,8 +188,18 @@ const arrayChildRegex = /[\d]+/;
 const numberRegex = /^-?\d+(?:\.\d*)?$/; // match only numbers (integers and floats)
 const cNumberTypeRegex = /\b(?:char|short|int|long|float|double)$/; // match C number types
 const cBoolRegex = /\bbool$/; // match boolean
+// -stack-info-depth counts the frames up to there, not the whole stack
+const maxStackDepth = 100;
 
 export function hexToBase64(hex: string): string {
+    const native = loadNativeMIParser()?.hex_to_base64;
+    if (native) {
+        const base64 = native(hex);
+        if (base64 === undefined) {
+            throw new Error('Received ill-formed hex input: ' + excerpt(hex));
+        }
+        return base64;
+    }
     // The buffer will ignore incomplete bytes (unpaired digits), so we need to catch that early
     if (hex.length % 2 !== 0) {
         throw new Error('Received memory with incomplete bytes.');
@@ -144,17 +207,33 @@ export function hexToBase64(hex: string): string {
     const base64 = Buffer.from(hex, 'hex').toString('base64');
     // If the hex input includes characters that are not hex digits, Buffer.from() will return an empty buffer, and the base64 string will be empty.
     if (base64.length === 0 && hex.length !== 0) {
-        throw new Error('Received ill-formed hex input: ' + hex);
+        throw new Error('Received ill-formed hex input: ' + excerpt(hex));
     }
     return base64;
 }
 
 export function base64ToHex(base64: string): string {
+    const native = loadNativeMIParser()?.base64_to_hex;
+    if (native) {
+        // validated while it is converted
+        const hex = native(base64);
+        if (hex === undefined) {
+            throw new Error(
+                'Received ill-formed base64 input: ' + excerpt(base64)
+            );
+        }
+        return hex;
+    }
     const buffer = Buffer.from(base64, 'base64');
     // The caller likely passed in a value that left dangling bits that couldn't be assigned to a full byte and so
     // were ignored by Buffer. We can't be sure what the client thought they wanted to do with those extra bits, so fail here.
-    if (buffer.length === 0 || !buffer.toString('base64').startsWith(base64)) {
-        throw new Error('Received ill-formed base64 input: ' + base64);
+    if (
+        (buffer.length === 0 && base64.length !== 0) ||
+        !buffer.toString('base64').startsWith(base64)
+    ) {
+        throw new Error(
+            'Received ill-formed base64 input: ' + excerpt(base64)
+        );
     }
     return buffer.toString('hex');
 }
@@ -179,11 +258,15 @@ export class GDBDebugSession extends LoggingDebugSession {
 
     protected supportsRunInTerminalRequest = false;
     protected supportsGdbConsole = false;
+    protected supportsProgressReporting = false;
+    protected progressCount = 0;
 
     /* A reference to the logger to be used by subclasses */
     protected logger: Logger.Logger;
 
     protected frameHandles = new Handles<FrameReference>();
+    // stops so far, the frames of the deepest stacks are told apart by it
+    protected stopCount = 0;
     protected variableHandles = new Handles<VariableReference>();
     protected functionBreakpoints: string[] = [];
     protected logPointMessages: { [key: string]: string } = {};
@@ -198,12 +281,52 @@ export class GDBDebugSession extends LoggingDebugSession {
     // therefore be resumed after breakpoints are inserted.
     protected waitPausedNeeded = false;
     protected isInitialized = false;
+    // settles once the program is loaded, breakpoints are inserted after that,
+    // rejects with the error that stopped loading it
+    protected programLoaded: Promise<void> = Promise.resolve();
+
+    // merges the console output of gdb into fewer output events
+    protected outputAggregator = new OutputAggregator((output, category) =>
+        this.sendEvent(new OutputEvent(output, category))
+    );
+
+    // the requests being handled, by seq, so that they can be cancelled
+    protected activeRequests = new Map<number, RequestContext>();
 
     constructor() {
         super();
         this.logger = logger;
     }
 
+    /**
+     * Pending console output is sent before any other event or response,
+     * so that they stay ordered the way gdb produced them.
+     */
+    public sendEvent(event: DebugProtocol.Event): void {
+        this.outputAggregator.flush();
+        super.sendEvent(event);
+    }
+
+    public sendResponse(response: DebugProtocol.Response): void {
+        this.activeRequests.delete(response.request_seq);
+        this.outputAggregator.flush();
+        super.sendResponse(response);
+    }
+
+    /**
+     * Handle each request in its own context, so that the commands it
+     * sends to gdb can be dropped if it is cancelled.
+     */
+    protected dispatchRequest(request: DebugProtocol.Request): void {
+        if (request.command === 'cancel') {
+            super.dispatchRequest(request);
+            return;
+        }
+        const context: RequestContext = { seq: request.seq, cancelled: false };
+        this.activeRequests.set(request.seq, context);
+        requestContext.run(context, () => super.dispatchRequest(request));
+    }
+
     /**
      * Main entry point
      */
@@ -279,6 +402,18 @@ export class GDBDebugSession extends LoggingDebugSession {
     ): void {
         if (command === 'cdt-gdb-adapter/Memory') {
             this.memoryRequest(response as MemoryResponse, args);
+        } else if (command === 'cdt-gdb-adapter/Stats') {
+            (response as StatsResponse).body = {
+                commands: this.gdb.getCommandStats(),
+                pool: gdbPool.stats(),
+                symbols: this.gdb.getSymbolLoads(),
+            };
+            this.sendResponse(response);
+        } else if (command === 'cdt-gdb-adapter/MITrace') {
+            (response as MITraceResponse).body = {
+                trace: this.gdb.tracer.dump(),
+            };
+            this.sendResponse(response);
             // This custom request exists to allow tests in this repository to run arbitrary commands
             // Use at your own risk!
         } else if (command === 'cdt-gdb-tests/executeCommand') {
@@ -324,6 +459,8 @@ export class GDBDebugSession extends LoggingDebugSession {
             args.supportsRunInTerminalRequest === true;
         this.supportsGdbConsole =
             os.platform() === 'linux' && this.supportsRunInTerminalRequest;
+        this.supportsProgressReporting =
+            args.supportsProgressReporting === true;
         response.body = response.body || {};
         response.body.supportsConfigurationDoneRequest = true;
         response.body.supportsSetVariable = true;
@@ -336,6 +473,7 @@ export class GDBDebugSession extends LoggingDebugSession {
         response.body.supportsReadMemoryRequest = true;
         response.body.supportsWriteMemoryRequest = true;
         response.body.supportsSteppingGranularity = true;
+        response.body.supportsCancelRequest = true;
         this.sendResponse(response);
     }
 
@@ -348,9 +486,16 @@ export class GDBDebugSession extends LoggingDebugSession {
             args.verbose ? Logger.LogLevel.Verbose : Logger.LogLevel.Warn,
             args.logFile || false
         );
+        this.gdb.tracer.verbose = !!args.verbose;
+        this.gdb.tracer.setBufferSize(args.miTraceBufferSize ?? 0);
+        this.gdb.commandTimeout = args.commandTimeout ?? 0;
+        this.gdb.captureCommandStacks = !!args.captureCommandStacks;
 
+        if (args.outputFlushThreshold !== undefined) {
+            this.outputAggregator.threshold = args.outputFlushThreshold;
+        }
         this.gdb.on('consoleStreamOutput', (output, category) => {
-            this.sendEvent(new OutputEvent(output, category));
+            this.outputAggregator.append(output, category);
         });
 
         this.gdb.on('execAsync', (resultClass, resultData) =>
@@ -369,10 +514,13 @@ export class GDBDebugSession extends LoggingDebugSession {
             );
             return;
         }
-        await this.gdb.sendFileExecAndSymbols(args.program);
-        await this.gdb.sendEnablePrettyPrint();
-
         if (request === 'attach') {
+            await this.gdb.pipeline(() =>
+                Promise.all([
+                    this.gdb.sendFileExecAndSymbols(args.program),
+                    this.gdb.sendEnablePrettyPrint(),
+                ])
+            );
             this.isAttach = true;
             const attachArgs = args as AttachRequestArguments;
             await mi.sendTargetAttachRequest(this.gdb, {
@@ -381,23 +529,70 @@ export class GDBDebugSession extends LoggingDebugSession {
             this.sendEvent(
                 new OutputEvent(`attached to process ${attachArgs.processId}`)
             );
-        }
-
-        await this.gdb.sendCommands(args.initCommands);
-
-        if (request === 'launch') {
+            await this.gdb.sendCommands(args.initCommands);
+            this.sendEvent(new InitializedEvent());
+        } else {
             const launchArgs = args as LaunchRequestArguments;
-            if (launchArgs.arguments) {
-                await mi.sendExecArguments(this.gdb, {
-                    arguments: launchArgs.arguments,
-                });
-            }
+            const loading = this.reportProgress(
+                'Loading symbols',
+                path.basename(args.program),
+                this.loadProgram(launchArgs)
+            );
+            this.programLoaded = loading;
+            // The client sends its breakpoints while the symbols load, they
+            // are pending until then. Loading errors fail the launch and the
+            // requests waiting for the program.
+            this.sendEvent(new InitializedEvent());
+            await loading;
         }
-        this.sendEvent(new InitializedEvent());
         this.sendResponse(response);
         this.isInitialized = true;
     }
 
+    /**
+     * Load the program to launch and run the initCommands. The adapter's
+     * own commands are sent at once, the initCommands one at a time and
+     * before the program arguments, which they could set too.
+     */
+    protected async loadProgram(args: LaunchRequestArguments) {
+        const initCommands = args.initCommands ?? [];
+        const sendArguments = () =>
+            args.arguments
+                ? mi.sendExecArguments(this.gdb, { arguments: args.arguments })
+                : undefined;
+        await this.gdb.pipeline(() =>
+            Promise.all([
+                this.gdb.sendFileExecAndSymbols(args.program),
+                this.gdb.sendEnablePrettyPrint(),
+                initCommands.length ? undefined : sendArguments(),
+            ])
+        );
+        if (initCommands.length) {
+            await this.gdb.sendCommands(initCommands);
+            await sendArguments();
+        }
+    }
+
+    /**
+     * Report a long operation as progress to the clients that support it.
+     */
+    protected async reportProgress<T>(
+        title: string,
+        message: string,
+        operation: Promise<T>
+    ): Promise<T> {
+        if (!this.supportsProgressReporting) {
+            return operation;
+        }
+        const progressId = `cdt-gdb-adapter-${++this.progressCount}`;
+        this.sendEvent(new ProgressStartEvent(progressId, title, message));
+        try {
+            return await operation;
+        } finally {
+            this.sendEvent(new ProgressEndEvent(progressId));
+        }
+    }
+
     protected async attachRequest(
         response: DebugProtocol.AttachResponse,
         args: AttachRequestArguments
@@ -409,6 +604,7 @@ export class GDBDebugSession extends LoggingDebugSession {
             );
             await this.attachOrLaunchRequest(response, request, resolvedArgs);
         } catch (err) {
+            this.gdb.tracer.dumpToLog('Failed to attach');
             this.sendErrorResponse(
                 response,
                 1,
@@ -428,6 +624,7 @@ export class GDBDebugSession extends LoggingDebugSession {
             );
             await this.attachOrLaunchRequest(response, request, resolvedArgs);
         } catch (err) {
+            this.gdb.tracer.dumpToLog('Failed to launch');
             this.sendErrorResponse(
                 response,
                 1,
@@ -448,7 +645,8 @@ export class GDBDebugSession extends LoggingDebugSession {
                 !(await this.gdb.supportsNewUi(
                     args.gdb,
                     getGdbCwd(args),
-                    args.environment
+                    args.environment,
+                    args.gdbProbeCache
                 ))
             ) {
                 logger.warn(
@@ -505,6 +703,16 @@ export class GDBDebugSession extends LoggingDebugSession {
         response: DebugProtocol.SetBreakpointsResponse,
         args: DebugProtocol.SetBreakpointsArguments
     ): Promise<void> {
+        try {
+            await this.programLoaded;
+        } catch (err) {
+            this.sendErrorResponse(
+                response,
+                1,
+                err instanceof Error ? err.message : String(err)
+            );
+            return;
+        }
         this.waitPausedNeeded = this.isRunning;
         if (this.waitPausedNeeded) {
             // Need to pause first
@@ -704,6 +912,16 @@ export class GDBDebugSession extends LoggingDebugSession {
         response: DebugProtocol.SetFunctionBreakpointsResponse,
         args: DebugProtocol.SetFunctionBreakpointsArguments
     ) {
+        try {
+            await this.programLoaded;
+        } catch (err) {
+            this.sendErrorResponse(
+                response,
+                1,
+                err instanceof Error ? err.message : String(err)
+            );
+            return;
+        }
         this.waitPausedNeeded = this.isRunning;
         if (this.waitPausedNeeded) {
             // Need to pause first
@@ -869,6 +1087,7 @@ export class GDBDebugSession extends LoggingDebugSession {
         _args: DebugProtocol.ConfigurationDoneArguments
     ): Promise<void> {
         try {
+            await this.programLoaded;
             this.sendEvent(
                 new OutputEvent(
                     '\n' +
@@ -940,7 +1159,7 @@ export class GDBDebugSession extends LoggingDebugSession {
         try {
             const threadId = args.threadId;
             const depthResult = await mi.sendStackInfoDepth(this.gdb, {
-                maxDepth: 100,
+                maxDepth: maxStackDepth,
                 threadId,
             });
             const depth = parseInt(depthResult.depth, 10);
@@ -951,13 +1170,14 @@ export class GDBDebugSession extends LoggingDebugSession {
                 : depth;
             const lowFrame = args.startFrame || 0;
             const highFrame = lowFrame + levels - 1;
+            // one frame more: its address is where the last one returns to
             const listResult = await mi.sendStackListFramesRequest(this.gdb, {
                 lowFrame,
-                highFrame,
+                highFrame: highFrame + 1,
                 threadId,
             });
 
-            const stack = listResult.stack.map((frame) => {
+            const stack = listResult.stack.slice(0, levels).map((frame, i) => {
                 let source;
                 if (frame.fullname) {
                     source = new Source(
@@ -969,9 +1189,16 @@ export class GDBDebugSession extends LoggingDebugSession {
                 if (frame.line) {
                     line = parseInt(frame.line, 10);
                 }
+                const frameId = parseInt(frame.level, 10);
                 const frameHandle = this.frameHandles.create({
                     threadId: args.threadId,
-                    frameId: parseInt(frame.level, 10),
+                    frameId,
+                    key: this.frameKey(
+                        depth,
+                        frameId,
+                        frame.func,
+                        listResult.stack[i + 1]?.addr
+                    ),
                 });
                 const name = frame.func || frame.fullname || '';
                 const sf = new StackFrame(
@@ -1092,6 +1319,28 @@ export class GDBDebugSession extends LoggingDebugSession {
         }
     }
 
+    /**
+     * Commands of the cancelled request that are not sent to gdb yet are
+     * dropped, and the request fails with the 'cancelled' message.
+     * Commands gdb already has run to completion.
+     */
+    protected cancelRequest(
+        response: DebugProtocol.CancelResponse,
+        args: DebugProtocol.CancelArguments
+    ): void {
+        const request =
+            args.requestId !== undefined
+                ? this.activeRequests.get(args.requestId)
+                : undefined;
+        if (request) {
+            const dropped = this.gdb.cancelCommands(request);
+            logger.verbose(
+                `Cancelled request ${request.seq}, dropped ${dropped} commands`
+            );
+        }
+        this.sendResponse(response);
+    }
+
     protected scopesRequest(
         response: DebugProtocol.ScopesResponse,
         args: DebugProtocol.ScopesArguments
@@ -1175,14 +1424,10 @@ export class GDBDebugSession extends LoggingDebugSession {
                 parentVarname +
                 (parentVarname === '' ? '' : '.') +
                 args.name.replace(/^\[(\d+)\]/, '$1');
-            const stackDepth = await mi.sendStackInfoDepth(this.gdb, {
-                maxDepth: 100,
-            });
-            const depth = parseInt(stackDepth.depth, 10);
+            const frameKey = await this.getFrameKey(frame);
             let varobj = this.gdb.varManager.getVar(
-                frame.frameId,
                 frame.threadId,
-                depth,
+                frameKey,
                 varname,
                 ref.type
             );
@@ -1193,9 +1438,8 @@ export class GDBDebugSession extends LoggingDebugSession {
                     threadId: frame.threadId,
                 });
                 varobj = this.gdb.varManager.addVar(
-                    frame.frameId,
                     frame.threadId,
-                    depth,
+                    frameKey,
                     args.name,
                     false,
                     false,
@@ -1210,6 +1454,7 @@ export class GDBDebugSession extends LoggingDebugSession {
                     varname: varobj.varname,
                     expression: args.value,
                 });
+                varobj.value = assign.value;
             } else {
                 try {
                     assign = await mi.sendVarAssign(this.gdb, {
@@ -1224,6 +1469,12 @@ export class GDBDebugSession extends LoggingDebugSession {
                         name: parentVarname,
                         printValues: mi.MIVarPrintValues.all,
                     });
+                    this.gdb.varManager.addChildren(
+                        frame.threadId,
+                        frameKey,
+                        parentVarname,
+                        children.children.length
+                    );
                     for (const child of children.children) {
                         if (this.isChildOfClass(child)) {
                             const grandchildVarname =
@@ -1231,9 +1482,8 @@ export class GDBDebugSession extends LoggingDebugSession {
                                 '.' +
                                 args.name.replace(/^\[(\d+)\]/, '$1');
                             varobj = this.gdb.varManager.getVar(
-                                frame.frameId,
                                 frame.threadId,
-                                depth,
+                                frameKey,
                                 grandchildVarname
                             );
                             try {
@@ -1319,14 +1569,10 @@ export class GDBDebugSession extends LoggingDebugSession {
                 return;
             }
 
-            const stackDepth = await mi.sendStackInfoDepth(this.gdb, {
-                maxDepth: 100,
-            });
-            const depth = parseInt(stackDepth.depth, 10);
+            const frameKey = await this.getFrameKey(frame);
             let varobj = this.gdb.varManager.getVar(
-                frame.frameId,
                 frame.threadId,
-                depth,
+                frameKey,
                 args.expression
             );
             if (!varobj) {
@@ -1336,52 +1582,38 @@ export class GDBDebugSession extends LoggingDebugSession {
                     threadId: frame.threadId,
                 });
                 varobj = this.gdb.varManager.addVar(
-                    frame.frameId,
                     frame.threadId,
-                    depth,
+                    frameKey,
                     args.expression,
                     false,
                     false,
                     varCreateResponse
                 );
             } else {
-                const vup = await mi.sendVarUpdate(this.gdb, {
-                    name: varobj.varname,
-                });
-                const update = vup.changelist[0];
-                if (update) {
-                    if (update.in_scope === 'true') {
-                        if (update.name === varobj.varname) {
-                            varobj.value = update.value;
+                // from the update of all the varobjs since the stop
+                await this.gdb.varManager.refresh();
+                if (varobj.outOfScope) {
+                    await this.gdb.varManager.removeVar(
+                        frame.threadId,
+                        frameKey,
+                        varobj.varname
+                    );
+                    const varCreateResponse = await mi.sendVarCreate(
+                        this.gdb,
+                        {
+                            expression: args.expression,
+                            frameId: frame.frameId,
+                            threadId: frame.threadId,
                         }
-                    } else {
-                        this.gdb.varManager.removeVar(
-                            frame.frameId,
-                            frame.threadId,
-                            depth,
-                            varobj.varname
-                        );
-                        await mi.sendVarDelete(this.gdb, {
-                            varname: varobj.varname,
-                        });
-                        const varCreateResponse = await mi.sendVarCreate(
-                            this.gdb,
-                            {
-                                expression: args.expression,
-                                frameId: frame.frameId,
-                                threadId: frame.threadId,
-                            }
-                        );
-                        varobj = this.gdb.varManager.addVar(
-                            frame.frameId,
-                            frame.threadId,
-                            depth,
-                            args.expression,
-                            false,
-                            false,
-                            varCreateResponse
-                        );
-                    }
+                    );
+                    varobj = this.gdb.varManager.addVar(
+                        frame.threadId,
+                        frameKey,
+                        args.expression,
+                        false,
+                        false,
+                        varCreateResponse
+                    );
                 }
             }
             if (varobj) {
@@ -1485,14 +1717,14 @@ export class GDBDebugSession extends LoggingDebugSession {
 
             const typedArgs = args as MemoryRequestArguments;
 
-            const result = await sendDataReadMemoryBytes(
+            const result = await sendDataReadMemoryBytesAsBuffer(
                 this.gdb,
                 typedArgs.address,
                 typedArgs.length,
                 typedArgs.offset
             );
             response.body = {
-                data: result.memory[0].contents,
+                data: result.memory[0].data.toString('hex'),
                 address: result.memory[0].begin,
             };
             this.sendResponse(response);
@@ -1628,14 +1860,16 @@ export class GDBDebugSession extends LoggingDebugSession {
     ): Promise<void> {
         try {
             if (args.count) {
-                const result = await sendDataReadMemoryBytes(
+                const result = await sendDataReadMemoryBytesAsBuffer(
                     this.gdb,
                     args.memoryReference,
                     args.count,
                     args.offset
                 );
+                // the parser decoded the hex already, the codec would
+                // need it again while Buffer encodes the bytes natively
                 response.body = {
-                    data: hexToBase64(result.memory[0].contents),
+                    data: result.memory[0].data.toString('base64'),
                     address: result.memory[0].begin,
                 };
                 this.sendResponse(response);
@@ -1710,6 +1944,7 @@ export class GDBDebugSession extends LoggingDebugSession {
         allThreadsStopped?: boolean
     ) {
         // Reset frame handles and variables for new context
+        this.stopCount++;
         this.frameHandles.reset();
         this.variableHandles.reset();
         // Send the event
@@ -1891,6 +2126,57 @@ export class GDBDebugSession extends LoggingDebugSession {
         }
     }
 
+    /**
+     * Identify a frame for as long as it is live, so that its varobjs are
+     * found again after calls from it or returns to it change its level:
+     * its height from the outermost frame, its function and the address
+     * it returns to in its caller. MI does not report the canonical frame
+     * address gdb identifies frames with, but gdb still binds each varobj
+     * to the frame it was created in and reports it out of scope once
+     * that frame is gone.
+     *
+     * @param depth of the stack, counted up to maxStackDepth. The height
+     * of the frames of deeper stacks is unknown, their key only lasts
+     * until the program stops again.
+     */
+    protected frameKey(
+        depth: number,
+        level: number,
+        func?: string,
+        callerAddr?: string
+    ): string {
+        const height =
+            depth < maxStackDepth
+                ? `${depth - level}`
+                : `${this.stopCount}@${level}`;
+        return `${height}:${func ?? ''}:${callerAddr ?? ''}`;
+    }
+
+    /** The key of a frame, see frameKey, the stack trace sets it */
+    protected async getFrameKey(frame: FrameReference): Promise<string> {
+        if (frame.key === undefined) {
+            const [stackDepth, frames] = await Promise.all([
+                mi.sendStackInfoDepth(this.gdb, {
+                    maxDepth: maxStackDepth,
+                    threadId: frame.threadId,
+                }),
+                mi.sendStackListFramesRequest(this.gdb, {
+                    lowFrame: frame.frameId,
+                    highFrame: frame.frameId + 1,
+                    threadId: frame.threadId,
+                }),
+            ]);
+            const [current, caller] = frames.stack;
+            frame.key = this.frameKey(
+                parseInt(stackDepth.depth, 10),
+                frame.frameId,
+                current?.func,
+                caller?.addr
+            );
+        }
+        return frame.key;
+    }
+
     protected async handleVariableRequestFrame(
         ref: FrameVariableReference
     ): Promise<DebugProtocol.Variable[]> {
@@ -1905,47 +2191,27 @@ export class GDBDebugSession extends LoggingDebugSession {
         let callStack = false;
         let numVars = 0;
 
-        // stack depth necessary for differentiating between similarly named variables at different stack depths
-        const stackDepth = await mi.sendStackInfoDepth(this.gdb, {
-            maxDepth: 100,
-        });
-        const depth = parseInt(stackDepth.depth, 10);
+        // varobjs of the same names are apart in each frame
+        const frameKey = await this.getFrameKey(frame);
 
         // array of varnames to delete. Cannot delete while iterating through the vars array below.
         const toDelete = new Array<string>();
 
-        // get the list of vars we need to update for this frameId/threadId/depth tuple
-        const vars = this.gdb.varManager.getVars(
-            frame.frameId,
-            frame.threadId,
-            depth
-        );
+        // get the list of vars we need to update for this frame
+        const vars = this.gdb.varManager.getVars(frame.threadId, frameKey);
         if (vars) {
+            // one update of all the varobjs per stop
+            await this.gdb.varManager.refresh();
             for (const varobj of vars) {
                 // ignore expressions and child entries
                 if (varobj.isVar && !varobj.isChild) {
-                    // request update from GDB
-                    const vup = await mi.sendVarUpdate(this.gdb, {
-                        name: varobj.varname,
-                    });
-                    // if changelist is length 0, update is undefined
-                    const update = vup.changelist[0];
                     let pushVar = true;
-                    if (update) {
-                        if (update.in_scope === 'true') {
-                            numVars++;
-                            if (update.name === varobj.varname) {
-                                // don't update the parent value to a child's value
-                                varobj.value = update.value;
-                            }
-                        } else {
-                            // var is out of scope, delete it and call sendStackListVariables() later
-                            callStack = true;
-                            pushVar = false;
-                            toDelete.push(update.name);
-                        }
-                    } else if (varobj.value) {
-                        // value hasn't updated but it's still in scope
+                    if (varobj.outOfScope) {
+                        // var is out of scope, delete it and call sendStackListVariables() later
+                        callStack = true;
+                        pushVar = false;
+                        toDelete.push(varobj.varname);
+                    } else {
                         numVars++;
                     }
                     // only push entries to the result that aren't being deleted
@@ -1974,16 +2240,18 @@ export class GDBDebugSession extends LoggingDebugSession {
                 }
             }
             // clean up out of scope entries
-            for (const varname of toDelete) {
-                await this.gdb.varManager.removeVar(
-                    frame.frameId,
-                    frame.threadId,
-                    depth,
-                    varname
-                );
-            }
+            await Promise.all(
+                toDelete.map((varname) =>
+                    this.gdb.varManager.removeVar(
+                        frame.threadId,
+                        frameKey,
+                        varname
+                    )
+                )
+            );
         }
-        // if we had out of scope entries or no entries in the frameId/threadId/depth tuple, query GDB for new ones
+        // if we had out of scope entries or no entries in the frame,
+        // query GDB for new ones
         if (callStack === true || numVars === 0) {
             const result = await mi.sendStackListVariables(this.gdb, {
                 thread: frame.threadId,
@@ -1992,9 +2260,8 @@ export class GDBDebugSession extends LoggingDebugSession {
             });
             for (const variable of result.variables) {
                 let varobj = this.gdb.varManager.getVar(
-                    frame.frameId,
                     frame.threadId,
-                    depth,
+                    frameKey,
                     variable.name
                 );
                 if (!varobj) {
@@ -2005,9 +2272,8 @@ export class GDBDebugSession extends LoggingDebugSession {
                         threadId: frame.threadId,
                     });
                     varobj = this.gdb.varManager.addVar(
-                        frame.frameId,
                         frame.threadId,
-                        depth,
+                        frameKey,
                         variable.name,
                         true,
                         false,
@@ -2018,7 +2284,7 @@ export class GDBDebugSession extends LoggingDebugSession {
                     varobj = await this.gdb.varManager.updateVar(
                         frame.frameId,
                         frame.threadId,
-                        depth,
+                        frameKey,
                         varobj
                     );
                     varobj.isVar = true;
@@ -2058,20 +2324,16 @@ export class GDBDebugSession extends LoggingDebugSession {
             return Promise.resolve(variables);
         }
 
-        // fetch stack depth to obtain frameId/threadId/depth tuple
-        const stackDepth = await mi.sendStackInfoDepth(this.gdb, {
-            maxDepth: 100,
-        });
-        const depth = parseInt(stackDepth.depth, 10);
+        // the frame the varobjs are kept for
+        const frameKey = await this.getFrameKey(frame);
         // we need to keep track of children and the parent varname in GDB
         let children;
         let parentVarname = ref.varobjName;
 
         // if a varobj exists, use the varname stored there
         const varobj = this.gdb.varManager.getVarByName(
-            frame.frameId,
             frame.threadId,
-            depth,
+            frameKey,
             ref.varobjName
         );
         if (varobj) {
@@ -2087,6 +2349,13 @@ export class GDBDebugSession extends LoggingDebugSession {
                 printValues: mi.MIVarPrintValues.all,
             });
         }
+        // gdb keeps the children it listed, they count toward the limit
+        this.gdb.varManager.addChildren(
+            frame.threadId,
+            frameKey,
+            parentVarname,
+            children.children.length
+        );
         // Grab the full path of parent.
         const topLevelPathExpression =
             varobj?.expression ??
@@ -2102,6 +2371,12 @@ export class GDBDebugSession extends LoggingDebugSession {
                     name,
                     printValues: mi.MIVarPrintValues.all,
                 });
+                this.gdb.varManager.addChildren(
+                    frame.threadId,
+                    frameKey,
+                    name,
+                    objChildren.children.length
+                );
                 // Append the child path to the top level full path.
                 const parentClassName = `${topLevelPathExpression}.${child.exp}`;
                 for (const objChild of objChildren.children) {
@@ -2144,9 +2419,8 @@ export class GDBDebugSession extends LoggingDebugSession {
                     );
                     // create or update the var in GDB
                     let arrobj = this.gdb.varManager.getVar(
-                        frame.frameId,
                         frame.threadId,
-                        depth,
+                        frameKey,
                         fullPath
                     );
                     if (!arrobj) {
@@ -2159,9 +2433,8 @@ export class GDBDebugSession extends LoggingDebugSession {
                             }
                         );
                         arrobj = this.gdb.varManager.addVar(
-                            frame.frameId,
                             frame.threadId,
-                            depth,
+                            frameKey,
                             fullPath,
                             true,
                             false,
@@ -2171,7 +2444,7 @@ export class GDBDebugSession extends LoggingDebugSession {
                         arrobj = await this.gdb.varManager.updateVar(
                             frame.frameId,
                             frame.threadId,
-                            depth,
+                            frameKey,
                             arrobj
                         );
                     }
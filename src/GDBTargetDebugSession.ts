@@ -156,6 +156,7 @@ export class GDBTargetDebugSession extends GDBDebugSession {
             );
             await this.attachOrLaunchRequest(response, request, resolvedArgs);
         } catch (err) {
+            this.gdb.tracer.dumpToLog('Failed to launch');
             this.sendErrorResponse(
                 response,
                 1,
@@ -175,6 +176,7 @@ export class GDBTargetDebugSession extends GDBDebugSession {
             );
             await this.attachOrLaunchRequest(response, request, resolvedArgs);
         } catch (err) {
+            this.gdb.tracer.dumpToLog('Failed to attach');
             this.sendErrorResponse(
                 response,
                 1,
@@ -188,9 +190,16 @@ export class GDBTargetDebugSession extends GDBDebugSession {
             args.verbose ? Logger.LogLevel.Verbose : Logger.LogLevel.Warn,
             args.logFile || false
         );
+        this.gdb.tracer.verbose = !!args.verbose;
+        this.gdb.tracer.setBufferSize(args.miTraceBufferSize ?? 0);
+        this.gdb.commandTimeout = args.commandTimeout ?? 0;
+        this.gdb.captureCommandStacks = !!args.captureCommandStacks;
 
+        if (args.outputFlushThreshold !== undefined) {
+            this.outputAggregator.threshold = args.outputFlushThreshold;
+        }
         this.gdb.on('consoleStreamOutput', (output, category) => {
-            this.sendEvent(new OutputEvent(output, category));
+            this.outputAggregator.append(output, category);
         });
 
         this.gdb.on('execAsync', (resultClass, resultData) =>
@@ -449,22 +458,23 @@ export class GDBTargetDebugSession extends GDBDebugSession {
         try {
             this.isAttach = true;
             await this.spawn(args);
-            await this.gdb.sendFileExecAndSymbols(args.program);
-            await this.gdb.sendEnablePrettyPrint();
-            if (args.imageAndSymbols) {
-                if (args.imageAndSymbols.symbolFileName) {
-                    if (args.imageAndSymbols.symbolOffset) {
-                        await this.gdb.sendAddSymbolFile(
-                            args.imageAndSymbols.symbolFileName,
-                            args.imageAndSymbols.symbolOffset
-                        );
-                    } else {
-                        await this.gdb.sendFileSymbolFile(
-                            args.imageAndSymbols.symbolFileName
-                        );
-                    }
-                }
-            }
+            const imageAndSymbols = args.imageAndSymbols;
+            await this.gdb.pipeline(() =>
+                Promise.all([
+                    this.gdb.sendFileExecAndSymbols(args.program),
+                    this.gdb.sendEnablePrettyPrint(),
+                    imageAndSymbols?.symbolFileName
+                        ? imageAndSymbols.symbolOffset
+                            ? this.gdb.sendAddSymbolFile(
+                                  imageAndSymbols.symbolFileName,
+                                  imageAndSymbols.symbolOffset
+                              )
+                            : this.gdb.sendFileSymbolFile(
+                                  imageAndSymbols.symbolFileName
+                              )
+                        : undefined,
+                ])
+            );
 
             if (target.connectCommands === undefined) {
                 this.targetType =
@@ -10,54 +10,312 @@
 import { Readable } from 'stream';
 import { logger } from '@vscode/debugadapter/lib/logger';
 import { GDBBackend } from './GDBBackend';
-import * as utf8 from 'utf8';
+import { MITrace } from './miTrace';
+import { TextDecoder } from 'util';
+import { performance } from 'perf_hooks';
+import {
+    CommandCallback,
+    CommandStats,
+    CommandTable,
+    PendingCommand,
+} from './commandTable';
+import {
+    loadNativeMIParser,
+    NativeMIParser,
+    NativeMIRecord,
+} from './native/mi-parser';
 
-type CommandQueue = {
-    [key: string]: (resultClass: string, resultData: any) => void;
-};
+/**
+ * Hints on how to decode the results of a command.
+ *
+ * The native parser decodes whole records, so the results of commands
+ * sent with lazy or fields are left to the TypeScript parser. That is
+ * usually slower than the native parser decoding everything, only use
+ * them where a benchmark shows otherwise.
+ */
+export interface MIResultOptions {
+    /**
+     * Only record where tuples and lists are in the response and decode
+     * them when they are first accessed. This saves time and memory for
+     * large responses when only a few fields are used.
+     */
+    lazy?: boolean;
+    /**
+     * Decode only these top-level results, the other ones may be skipped
+     * and missing from the result.
+     */
+    fields?: string[];
+    /**
+     * The hex `contents` of the tuples in the `memory` list are decoded
+     * into a Buffer, set as `data`, and `contents` is left empty. This is
+     * done by both parsers.
+     */
+    hexContents?: boolean;
+}
+
+const contentsMarker = Buffer.from('contents="');
+
+const utf8Decoder = new TextDecoder('utf-8', { fatal: true });
+
+const hexValues = new Int16Array(256).fill(-1);
+for (let i = 0; i < 16; i++) {
+    hexValues['0123456789abcdef'.charCodeAt(i)] = i;
+    hexValues['0123456789ABCDEF'.charCodeAt(i)] = i;
+}
+
+/**
+ * Decode the hex digits in src between start and end.
+ *
+ * @returns the bytes, or undefined if they are not valid hex
+ */
+function hexToBuffer(src: Buffer, start: number, end: number) {
+    if ((end - start) % 2 !== 0) {
+        return undefined;
+    }
+    const result = Buffer.allocUnsafe((end - start) / 2);
+    let invalid = 0;
+    for (let i = 0, j = start; j < end; i++, j += 2) {
+        const high = hexValues[src[j]];
+        const low = hexValues[src[j + 1]];
+        invalid |= high | low;
+        result[i] = (high << 4) | low;
+    }
+    // -1 has all the bits set
+    return invalid < 0 ? undefined : result;
+}
 
 export class MIParser {
     protected line = '';
     protected pos = 0;
 
-    protected commandQueue: CommandQueue = {};
+    protected commands = new CommandTable();
+    protected lazy = false;
     protected waitReady?: (value?: void | PromiseLike<void>) => void;
+    protected onData?: (chunk: Buffer | string) => void;
+    protected pendingChunks: Buffer[] = [];
+    /** Reused for the bytes of C strings with escape sequences */
+    protected scratch = Buffer.allocUnsafe(1024);
 
-    constructor(protected gdb: GDBBackend) {}
+    /**
+     * Native record parser, used when it has been built for this platform.
+     * Lines it does not recognize are handed to the TypeScript parser.
+     */
+    protected nativeParser?: NativeMIParser = loadNativeMIParser();
+
+    constructor(
+        protected gdb: GDBBackend,
+        protected tracer: MITrace = gdb.tracer ?? new MITrace()
+    ) {}
 
     public parse(stream: Readable): Promise<void> {
         return new Promise((resolve) => {
             this.waitReady = resolve;
-            const lineBreakRegex = /\r?\n/;
-            let buff = '';
-            stream.on('data', (chunk) => {
-                const newChunk = chunk.toString();
-                let regexArray = lineBreakRegex.exec(newChunk);
-                if (regexArray) {
-                    regexArray.index += buff.length;
-                }
-                buff += newChunk;
-                while (regexArray) {
-                    const line = buff.slice(0, regexArray.index);
-                    this.parseLine(line);
-                    buff = buff.slice(regexArray.index + regexArray[0].length);
-                    regexArray = lineBreakRegex.exec(buff);
-                }
-            });
+            this.listen(stream);
         });
     }
 
-    public parseLine(line: string) {
-        this.line = line;
+    /**
+     * Parse the output of a gdb that is already past its first prompt.
+     */
+    public listen(stream: Readable) {
+        this.onData = (chunk: Buffer | string) => {
+            this.frameLines(
+                typeof chunk === 'string' ? Buffer.from(chunk) : chunk
+            );
+        };
+        stream.on('data', this.onData);
+    }
+
+    /** Stop parsing stream, so that another parser can take it over */
+    public stopListening(stream: Readable) {
+        if (this.onData) {
+            stream.off('data', this.onData);
+            this.onData = undefined;
+        }
+    }
+
+    /**
+     * Split incoming data into lines and parse them.
+     *
+     * The data is scanned at the byte level and chunks without a line
+     * terminator are only kept as views on the original buffers. They get
+     * joined once, when the end of the line arrives, so that very long
+     * records cost linear time in the number of bytes received.
+     */
+    protected frameLines(chunk: Buffer) {
+        let start = 0;
+        let end = chunk.indexOf(0x0a);
+        while (end !== -1) {
+            let line = chunk.subarray(start, end);
+            if (this.pendingChunks.length) {
+                this.pendingChunks.push(line);
+                line = Buffer.concat(this.pendingChunks);
+                this.pendingChunks = [];
+            }
+            if (line.length && line[line.length - 1] === 0x0d) {
+                line = line.subarray(0, line.length - 1);
+            }
+            this.parseLine(line);
+            start = end + 1;
+            end = chunk.indexOf(0x0a, start);
+        }
+        if (start < chunk.length) {
+            this.pendingChunks.push(chunk.subarray(start));
+        }
+    }
+
+    public parseLine(line: string | Buffer) {
+        if (this.tracer.enabled) {
+            this.tracer.traceIn(line);
+        }
+        if (this.commands.hasOptions && this.handleHexContents(line)) {
+            return;
+        }
+        this.parseRecord(line);
+    }
+
+    protected parseRecord(line: string | Buffer) {
+        if (this.nativeParser && !this.decodesSelectively(line)) {
+            const record = this.nativeParser.parse_record(
+                typeof line === 'string' ? Buffer.from(line) : line
+            );
+            if (record) {
+                this.handleRecord(record);
+                return;
+            }
+        }
+        this.line = line.toString();
         this.pos = 0;
         this.handleLine();
     }
 
+    /**
+     * Whether line is the result of a command with the lazy or fields
+     * options. The native parser decodes whole records, so those results
+     * are left to the TypeScript one.
+     */
+    protected decodesSelectively(line: string | Buffer) {
+        if (!this.commands.hasOptions) {
+            return false;
+        }
+        const token = this.resultToken(line);
+        if (!token) {
+            return false;
+        }
+        const options = this.commands.get(parseInt(token, 10))?.options;
+        return !!options && (!!options.lazy || !!options.fields);
+    }
+
+    /**
+     * Returns the token of a result record, or undefined if line is not a
+     * result record.
+     */
+    protected resultToken(line: string | Buffer) {
+        let token = '';
+        for (let i = 0; i < line.length; i++) {
+            const c =
+                typeof line === 'string' ? line.charCodeAt(i) : line[i];
+            if (c >= 0x30 && c <= 0x39) {
+                token += String.fromCharCode(c);
+            } else {
+                return c === 0x5e /* ^ */ ? token : undefined;
+            }
+        }
+        return undefined;
+    }
+
+    /**
+     * For commands with the hexContents option, decode the hex `contents`
+     * fields straight from the line into Buffers, without creating strings
+     * for them. The rest of the record is parsed as usual and the Buffers
+     * are added to the tuples of `memory` as `data`.
+     *
+     * @returns false if line was not handled
+     */
+    protected handleHexContents(line: string | Buffer) {
+        const token = this.resultToken(line);
+        if (token === undefined) {
+            return false;
+        }
+        const command = this.commands.get(parseInt(token, 10));
+        if (!command || !command.options?.hexContents) {
+            return false;
+        }
+
+        const bytes = typeof line === 'string' ? Buffer.from(line) : line;
+        const pieces: Buffer[] = [];
+        const contents: Buffer[] = [];
+        let pos = 0;
+        let start = bytes.indexOf(contentsMarker);
+        while (start !== -1) {
+            const begin = start + contentsMarker.length;
+            const end = bytes.indexOf(0x22 /* " */, begin);
+            const data = end !== -1 && this.decodeHex(bytes, begin, end);
+            if (!data) {
+                // Not what we expected, let the parsers deal with it
+                return false;
+            }
+            pieces.push(bytes.subarray(pos, begin));
+            contents.push(data);
+            pos = end;
+            start = bytes.indexOf(contentsMarker, pos);
+        }
+        if (!contents.length) {
+            return false;
+        }
+        pieces.push(bytes.subarray(pos));
+
+        const callback = command.callback;
+        command.callback = (resultClass, resultData) => {
+            if (resultClass === 'done' && Array.isArray(resultData.memory)) {
+                resultData.memory.forEach((memory: any, index: number) => {
+                    if (memory && index < contents.length) {
+                        memory.data = contents[index];
+                    }
+                });
+            }
+            callback(resultClass, resultData);
+        };
+        this.parseRecord(Buffer.concat(pieces));
+        return true;
+    }
+
+    /** Decode hex digits, with the native codec when it is available */
+    protected decodeHex(src: Buffer, start: number, end: number) {
+        return this.nativeParser?.hex_to_bytes
+            ? this.nativeParser.hex_to_bytes(src, start, end)
+            : hexToBuffer(src, start, end);
+    }
+
+    /**
+     * Register the callback for the result of the command with this token.
+     *
+     * @returns the entry of the command in the pending command table
+     */
     public queueCommand(
         token: number,
-        command: (resultClass: string, resultData: any) => void
-    ) {
-        this.commandQueue[token] = command;
+        callback: CommandCallback,
+        options?: MIResultOptions
+    ): PendingCommand {
+        const command: PendingCommand = {
+            token,
+            callback,
+            options,
+            sent: performance.now(),
+        };
+        this.commands.add(command);
+        return command;
+    }
+
+    /**
+     * Fail the command if its result did not arrive after timeout ms.
+     */
+    public setCommandTimeout(command: PendingCommand, timeout: number) {
+        this.commands.setTimeout(command, timeout);
+    }
+
+    public getCommandStats(): CommandStats {
+        return this.commands.stats();
     }
 
     protected peek() {
@@ -96,66 +354,102 @@ export class MIParser {
     }
 
     protected handleCString() {
-        let c = this.next();
+        const c = this.next();
         if (!c || c !== '"') {
             return null;
         }
 
-        let cstring = '';
-        let octal = '';
-        mainloop: for (c = this.next(); c; c = this.next()) {
-            if (octal) {
-                octal += c;
-                if (octal.length == 3) {
-                    cstring += String.fromCodePoint(parseInt(octal, 8));
-                    octal = '';
-                }
-                continue;
+        const line = this.line;
+        const start = this.pos;
+        const quote = line.indexOf('"', start);
+        const backslash = line.indexOf('\\', start);
+        if (quote !== -1 && (backslash === -1 || backslash > quote)) {
+            // No escape sequences, the characters are already decoded
+            this.pos = quote + 1;
+            return line.slice(start, quote);
+        }
+
+        // Unescape into bytes, escape sequences are octal bytes of UTF-8
+        let length = 0;
+        let ascii = true;
+        let pos = start;
+        while (pos < line.length) {
+            if (this.scratch.length - length < 4) {
+                const scratch = Buffer.allocUnsafe(this.scratch.length * 2);
+                this.scratch.copy(scratch, 0, 0, length);
+                this.scratch = scratch;
             }
-            switch (c) {
-                case '"':
-                    break mainloop;
-                case '\\':
-                    c = this.next();
-                    if (c) {
-                        switch (c) {
-                            case 'n':
-                                cstring += '\n';
-                                break;
-                            case 't':
-                                cstring += '\t';
-                                break;
-                            case 'r':
-                                break;
-                            case '0':
-                            case '1':
-                            case '2':
-                            case '3':
-                            case '4':
-                            case '5':
-                            case '6':
-                            case '7':
-                                octal = c;
-                                break;
-                            default:
-                                cstring += c;
-                        }
-                    } else {
-                        this.back();
-                    }
+            let code = line.charCodeAt(pos++);
+            if (code === 0x22 /* " */) {
+                break;
+            }
+            if (code === 0x5c /* \ */) {
+                if (pos >= line.length) {
                     break;
-                default:
-                    cstring += c;
+                }
+                code = line.charCodeAt(pos++);
+                switch (code) {
+                    case 0x6e /* n */:
+                        code = 0x0a;
+                        break;
+                    case 0x74 /* t */:
+                        code = 0x09;
+                        break;
+                    case 0x72 /* r */:
+                        continue;
+                    default:
+                        if (code >= 0x30 && code <= 0x37) {
+                            // Three characters, like parseInt(octal, 8) only
+                            // the leading octal digits count
+                            if (pos + 2 > line.length) {
+                                pos = line.length;
+                                continue;
+                            }
+                            code -= 0x30;
+                            for (let i = 0; i < 2; i++) {
+                                const digit = line.charCodeAt(pos + i) - 0x30;
+                                if (digit < 0 || digit > 7) {
+                                    break;
+                                }
+                                code = code * 8 + digit;
+                            }
+                            pos += 2;
+                            code &= 0xff;
+                            ascii = ascii && code < 0x80;
+                            this.scratch[length++] = code;
+                            continue;
+                        }
+                }
+            }
+            if (code < 0x80) {
+                this.scratch[length++] = code;
+            } else {
+                // A character that was not escaped, encode it back
+                ascii = false;
+                const low = line.charCodeAt(pos);
+                const surrogates =
+                    code >= 0xd800 &&
+                    code <= 0xdbff &&
+                    low >= 0xdc00 &&
+                    low <= 0xdfff;
+                const end = surrogates ? pos + 1 : pos;
+                length += this.scratch.write(line.slice(pos - 1, end), length);
+                pos = end;
             }
         }
+        this.pos = pos;
 
+        if (ascii) {
+            return this.scratch.toString('latin1', 0, length);
+        }
         try {
-            return utf8.decode(cstring);
+            return utf8Decoder.decode(this.scratch.subarray(0, length));
         } catch (err) {
-            logger.error(
-                `Failed to decode cstring '${cstring}'. ${JSON.stringify(err)}`
+            // Not UTF-8, keep the bytes as they are
+            logger.verbose(
+                `Failed to decode cstring as UTF-8. ${JSON.stringify(err)}`
             );
-            return cstring;
+            return this.scratch.toString('latin1', 0, length);
         }
     }
 
@@ -236,7 +530,9 @@ export class MIParser {
             case '"':
                 return this.handleCString();
             case '{':
-                return this.handleObject();
+                return this.lazy
+                    ? this.handleLazyObject()
+                    : this.handleObject();
             case '[':
                 return this.handleArray();
             default:
@@ -249,8 +545,11 @@ export class MIParser {
         return null;
     }
 
-    protected handleAsyncData() {
+    protected handleAsyncData(options?: MIResultOptions) {
         const result: any = {};
+        const fields = options?.fields;
+        const lazy = this.lazy;
+        this.lazy = !!options?.lazy;
 
         let c = this.next();
         let name = 'missing';
@@ -258,8 +557,16 @@ export class MIParser {
             if (this.peek() !== '{') {
                 name = this.handleString();
                 if (this.next() === '=') {
-                    result[name] = this.handleValue();
+                    if (fields && fields.indexOf(name) === -1) {
+                        this.skipValue();
+                    } else if (this.lazy) {
+                        this.handleLazyValue(result, name);
+                    } else {
+                        result[name] = this.handleValue();
+                    }
                 }
+            } else if (fields && fields.indexOf(name) === -1) {
+                this.skipValue();
             } else {
                 // In some cases, such as -break-insert with multiple results
                 // GDB does not return an array, so we have to identify that
@@ -275,9 +582,158 @@ export class MIParser {
             c = this.next();
         }
 
+        this.lazy = lazy;
         return result;
     }
 
+    /**
+     * Like handleObject, but the tuples and lists it contains are only
+     * decoded when they are accessed.
+     */
+    protected handleLazyObject() {
+        let c = this.next();
+        if (c !== '{') {
+            return null;
+        }
+        if (this.peek() === '"') {
+            // "object" contains just values
+            this.back();
+            return this.handleObject();
+        }
+        const result: any = {};
+        c = this.next();
+        while (c && c !== '}') {
+            if (c !== ',') {
+                this.back();
+            }
+            const name = this.handleString();
+            if (this.next() === '=') {
+                this.handleLazyValue(result, name);
+            }
+            c = this.next();
+        }
+
+        return c === '}' ? result : null;
+    }
+
+    /**
+     * Set `name` on `result` to the value at the current position. Strings
+     * are decoded right away, tuples and lists when they are first
+     * accessed.
+     */
+    protected handleLazyValue(result: any, name: string) {
+        const c = this.peek();
+        if (c === '{' || c === '[') {
+            this.defineLazyValue(result, name);
+        } else {
+            result[name] = this.handleValue();
+        }
+    }
+
+    /**
+     * Define `name` on `result` as the value at the current position,
+     * decoded on first access. The value is skipped.
+     */
+    protected defineLazyValue(result: any, name: string) {
+        const line = this.line;
+        const start = this.pos;
+        const define = (value: any) => {
+            Object.defineProperty(result, name, {
+                value,
+                writable: true,
+                enumerable: true,
+                configurable: true,
+            });
+        };
+        Object.defineProperty(result, name, {
+            get: () => {
+                const value = this.decodeValueAt(line, start);
+                define(value);
+                return value;
+            },
+            set: define,
+            enumerable: true,
+            configurable: true,
+        });
+        this.skipValue();
+    }
+
+    protected decodeValueAt(line: string, pos: number) {
+        const saved = { line: this.line, pos: this.pos, lazy: this.lazy };
+        this.line = line;
+        this.pos = pos;
+        this.lazy = true;
+        try {
+            return this.handleValue();
+        } finally {
+            this.line = saved.line;
+            this.pos = saved.pos;
+            this.lazy = saved.lazy;
+        }
+    }
+
+    /**
+     * Move past the value at the current position without decoding it.
+     */
+    protected skipValue() {
+        const c = this.peek();
+        if (c === '"') {
+            this.skipCString();
+        } else if (c === '{' || c === '[') {
+            const delimiters = /["{}[\]]/g;
+            let depth = 0;
+            let match: RegExpExecArray | null;
+            delimiters.lastIndex = this.pos;
+            while ((match = delimiters.exec(this.line))) {
+                this.pos = match.index;
+                switch (match[0]) {
+                    case '"':
+                        this.skipCString();
+                        delimiters.lastIndex = this.pos;
+                        continue;
+                    case '{':
+                    case '[':
+                        depth++;
+                        break;
+                    default:
+                        depth--;
+                }
+                if (depth === 0) {
+                    this.pos++;
+                    return;
+                }
+            }
+            this.pos = this.line.length;
+        } else {
+            // A weird array element with a name, skip the name and the value
+            this.handleString();
+            if (this.next() === '=') {
+                this.skipValue();
+            }
+        }
+    }
+
+    protected skipCString() {
+        // skip the opening quote
+        let end = this.pos + 1;
+        for (;;) {
+            end = this.line.indexOf('"', end);
+            if (end === -1) {
+                this.pos = this.line.length;
+                return;
+            }
+            let backslashes = 0;
+            while (this.line[end - 1 - backslashes] === '\\') {
+                backslashes++;
+            }
+            end++;
+            if (backslashes % 2 === 0) {
+                this.pos = end;
+                return;
+            }
+        }
+    }
+
     protected handleConsoleStream() {
         const msg = this.handleCString();
         if (msg) {
@@ -292,6 +748,89 @@ export class MIParser {
         }
     }
 
+    /**
+     * Remove the command a result record is for from the table.
+     */
+    protected takeCommand(token: string) {
+        const command = token
+            ? this.commands.take(parseInt(token, 10))
+            : undefined;
+        if (!command) {
+            const message = 'GDB response with no command: ' + token;
+            logger.error(message);
+            this.tracer.dumpToLog(message);
+        }
+        return command;
+    }
+
+    protected completeCommand(
+        command: PendingCommand,
+        resultClass: string,
+        resultData: any
+    ) {
+        if (command.timedOut) {
+            logger.verbose(
+                `GDB result of timed out command ${command.token} ignored`
+            );
+            return;
+        }
+        command.callback(resultClass, resultData);
+    }
+
+    protected handlePrompt() {
+        // this is the (gdb) prompt and used
+        // to know that GDB has started and is ready
+        // for commands
+        if (this.waitReady) {
+            this.waitReady();
+            this.waitReady = undefined;
+        }
+    }
+
+    /**
+     * Dispatch a record decoded by the native parser, the same way
+     * handleLine does for the TypeScript parser.
+     */
+    protected handleRecord(record: NativeMIRecord) {
+        const token = record.token;
+        switch (record.type) {
+            case '^': {
+                const command = this.takeCommand(token);
+                if (command) {
+                    this.completeCommand(
+                        command,
+                        record.recordClass as string,
+                        record.data
+                    );
+                }
+                break;
+            }
+            case '~':
+            case '@':
+                if (record.text) {
+                    this.gdb.emit('consoleStreamOutput', record.text, 'stdout');
+                }
+                break;
+            case '&':
+                if (record.text) {
+                    this.gdb.emit('consoleStreamOutput', record.text, 'log');
+                }
+                break;
+            case '=':
+                this.gdb.emit('notifyAsync', record.recordClass, record.data);
+                break;
+            case '*':
+                this.gdb.emit('execAsync', record.recordClass, record.data);
+                break;
+            case '+':
+                this.gdb.emit('statusAsync', record.recordClass, record.data);
+                break;
+            case '(':
+                this.handlePrompt();
+                break;
+        }
+    }
+
     protected handleLine() {
         let c = this.next();
         if (!c) {
@@ -307,21 +846,14 @@ export class MIParser {
 
         switch (c) {
             case '^': {
-                const rest = this.restOfLine();
-                for (let i = 0; i < rest.length; i += 1000) {
-                    const msg = i === 0 ? 'result' : '-cont-';
-                    logger.verbose(
-                        `GDB ${msg}: ${token} ${rest.substr(i, 1000)}`
-                    );
-                }
-                const command = this.commandQueue[token];
+                const command = this.takeCommand(token);
                 if (command) {
                     const resultClass = this.handleString();
-                    const resultData = this.handleAsyncData();
-                    command(resultClass, resultData);
-                    delete this.commandQueue[token];
-                } else {
-                    logger.error('GDB response with no command: ' + token);
+                    // errors are always fully decoded, they only have a msg
+                    const resultData = this.handleAsyncData(
+                        resultClass !== 'error' ? command.options : undefined
+                    );
+                    this.completeCommand(command, resultClass, resultData);
                 }
                 break;
             }
@@ -333,7 +865,6 @@ export class MIParser {
                 this.handleLogStream();
                 break;
             case '=': {
-                logger.verbose('GDB notify async: ' + this.restOfLine());
                 const notifyClass = this.handleString();
                 this.gdb.emit(
                     'notifyAsync',
@@ -343,13 +874,11 @@ export class MIParser {
                 break;
             }
             case '*': {
-                logger.verbose('GDB exec async: ' + this.restOfLine());
                 const execClass = this.handleString();
                 this.gdb.emit('execAsync', execClass, this.handleAsyncData());
                 break;
             }
             case '+': {
-                logger.verbose('GDB status async: ' + this.restOfLine());
                 const statusClass = this.handleString();
                 this.gdb.emit(
                     'statusAsync',
@@ -359,13 +888,7 @@ export class MIParser {
                 break;
             }
             case '(':
-                // this is the (gdb) prompt and used
-                // to know that GDB has started and is ready
-                // for commands
-                if (this.waitReady) {
-                    this.waitReady();
-                    this.waitReady = undefined;
-                }
+                this.handlePrompt();
                 break;
             default:
                 // treat as console output. happens on Windows.
@@ -0,0 +1,161 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Compares MIParser.handleCString with the implementation it replaced,
+ * which built a string of octal escaped "bytes" and decoded it with the
+ * utf8 package. The strings are the C strings of the MI output of a
+ * session on the vars_cpp and bug275-测试 test programs.
+ */
+
+import * as utf8 from 'utf8';
+import { GDBBackend } from '../GDBBackend';
+import { MIParser } from '../MIParser';
+import { bench } from './harness';
+
+const varsCpp = [
+    '"/home/user/cdt-gdb-adapter/src/integration-tests/test-programs/vars_cpp.cpp"',
+    '"vars_cpp.cpp"',
+    '"main"',
+    '"0x0000555555555213"',
+    '"Foo *"',
+    '"0x55555556aeb0"',
+    '"{a = 1, b = 2, c = 97 \'a\'}"',
+    '"97 \'a\'"',
+    '"{0x55555556aeb0, 0x55555556aed0}"',
+    '"breakpoint-hit"',
+    '"!!!Hello World!!!\\n"',
+    '"Breakpoint 1, main () at vars_cpp.cpp:37\\n"',
+    '"37\\t    cout << \\"!!!Hello World!!!\\" << endl; // STOP HERE\\n"',
+    '"[Thread debugging using libthread_db enabled]\\n"',
+    '"Using host libthread_db library \\"/lib/x86_64-linux-gnu/libthread_db.so.1\\".\\n"',
+];
+
+const bug275 = [
+    '"/home/user/cdt-gdb-adapter/src/integration-tests/test-programs/bug275-\\346\\265\\213\\350\\257\\225"',
+    '"bug275-\\346\\265\\213\\350\\257\\225.c"',
+    '"/home/user/cdt-gdb-adapter/src/integration-tests/test-programs/bug275-\\346\\265\\213\\350\\257\\225.c"',
+    '"Breakpoint 1, main (argc=1, argv=0x7fffffffe0a8) at bug275-\\346\\265\\213\\350\\257\\225.c:3\\n"',
+    '"0x7fffffffe0a8"',
+    '"char **"',
+];
+
+class CStringParser extends MIParser {
+    constructor() {
+        super({} as GDBBackend);
+    }
+
+    public decode(cstring: string) {
+        this.line = cstring;
+        this.pos = 0;
+        return this.handleCString();
+    }
+}
+
+/** MIParser.handleCString before it was rewritten */
+function legacyHandleCString(line: string) {
+    let pos = 0;
+    const next = () => (pos < line.length ? line[pos++] : null);
+    let c = next();
+    if (!c || c !== '"') {
+        return null;
+    }
+
+    let cstring = '';
+    let octal = '';
+    mainloop: for (c = next(); c; c = next()) {
+        if (octal) {
+            octal += c;
+            if (octal.length == 3) {
+                cstring += String.fromCodePoint(parseInt(octal, 8));
+                octal = '';
+            }
+            continue;
+        }
+        switch (c) {
+            case '"':
+                break mainloop;
+            case '\\':
+                c = next();
+                if (c) {
+                    switch (c) {
+                        case 'n':
+                            cstring += '\n';
+                            break;
+                        case 't':
+                            cstring += '\t';
+                            break;
+                        case 'r':
+                            break;
+                        case '0':
+                        case '1':
+                        case '2':
+                        case '3':
+                        case '4':
+                        case '5':
+                        case '6':
+                        case '7':
+                            octal = c;
+                            break;
+                        default:
+                            cstring += c;
+                    }
+                }
+                break;
+            default:
+                cstring += c;
+        }
+    }
+
+    try {
+        return utf8.decode(cstring);
+    } catch (err) {
+        return cstring;
+    }
+}
+
+async function main() {
+    const parser = new CStringParser();
+    for (const [name, strings] of [
+        ['vars_cpp', varsCpp],
+        ['bug275', bug275],
+    ] as Array<[string, string[]]>) {
+        for (const cstring of strings) {
+            const expected = legacyHandleCString(cstring);
+            if (parser.decode(cstring) !== expected) {
+                throw new Error(`${cstring} decoded differently`);
+            }
+        }
+        const bytes = strings.reduce((sum, s) => sum + s.length, 0) * 1000;
+        await bench(
+            `handleCString ${name}`,
+            () => {
+                for (let i = 0; i < 1000; i++) {
+                    strings.forEach((cstring) => parser.decode(cstring));
+                }
+            },
+            { bytes }
+        );
+        await bench(
+            `legacy handleCString ${name}`,
+            () => {
+                for (let i = 0; i < 1000; i++) {
+                    strings.forEach((cstring) => legacyHandleCString(cstring));
+                }
+            },
+            { bytes }
+        );
+    }
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exitCode = 1;
+});
@@ -0,0 +1,111 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Measures how MIParser splits the GDB output stream into lines, for
+ * records from 1 KB to 64 MB delivered in randomly sized chunks. The
+ * string based framing that MIParser used before is measured too, for
+ * comparison.
+ */
+
+import { GDBBackend } from '../GDBBackend';
+import { MIParser } from '../MIParser';
+import { bench, formatBytes, random } from './harness';
+
+class FramingParser extends MIParser {
+    public bytes = 0;
+
+    constructor() {
+        super({} as GDBBackend);
+    }
+
+    public feed(chunk: Buffer) {
+        this.frameLines(chunk);
+    }
+
+    public parseLine(line: string | Buffer) {
+        this.bytes += line.length;
+    }
+}
+
+/** The framing MIParser.parse did before it worked on Buffers */
+class LegacyFraming {
+    public bytes = 0;
+    protected buff = '';
+    protected lineBreakRegex = /\r?\n/;
+
+    public feed(chunk: Buffer) {
+        const newChunk = chunk.toString();
+        let regexArray = this.lineBreakRegex.exec(newChunk);
+        if (regexArray) {
+            regexArray.index += this.buff.length;
+        }
+        this.buff += newChunk;
+        while (regexArray) {
+            const line = this.buff.slice(0, regexArray.index);
+            this.bytes += line.length;
+            this.buff = this.buff.slice(
+                regexArray.index + regexArray[0].length
+            );
+            regexArray = this.lineBreakRegex.exec(this.buff);
+        }
+    }
+}
+
+/** Build one result record of `size` bytes split in chunks of up to 64 KB */
+function makeChunks(size: number, seed: number): Buffer[] {
+    const prefix = '1^done,value="';
+    const suffix = '"\n';
+    const record = Buffer.alloc(size, 'x');
+    record.write(prefix);
+    record.write(suffix, size - suffix.length);
+
+    const next = random(seed);
+    const chunks: Buffer[] = [];
+    let offset = 0;
+    while (offset < size) {
+        const length = 1 + Math.floor(next() * 64 * 1024);
+        chunks.push(record.subarray(offset, offset + length));
+        offset += length;
+    }
+    return chunks;
+}
+
+async function main() {
+    const sizes = [1, 16, 256, 4 * 1024, 64 * 1024].map((kb) => kb * 1024);
+    for (const size of sizes) {
+        const chunks = makeChunks(size, size);
+        const iterations = size > 4 * 1024 * 1024 ? 3 : 10;
+        await bench(
+            `framing ${formatBytes(size)}`,
+            () => {
+                const parser = new FramingParser();
+                chunks.forEach((chunk) => parser.feed(chunk));
+                if (parser.bytes !== size - 1) {
+                    throw new Error(`Expected one ${size - 1} bytes line`);
+                }
+            },
+            { iterations, bytes: size }
+        );
+        await bench(
+            `legacy framing ${formatBytes(size)}`,
+            () => {
+                const framing = new LegacyFraming();
+                chunks.forEach((chunk) => framing.feed(chunk));
+            },
+            { iterations, bytes: size }
+        );
+    }
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exitCode = 1;
+});
@@ -0,0 +1,107 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Minimal helpers shared by the micro-benchmarks in this directory.
+ * Benchmarks are plain scripts, run them with `yarn bench:<name>`.
+ */
+
+import { performance } from 'perf_hooks';
+
+export interface BenchmarkResult {
+    name: string;
+    iterations: number;
+    /** Mean time of one iteration, in milliseconds */
+    mean: number;
+    /** Fastest iteration, in milliseconds */
+    min: number;
+    /** Bytes processed by one iteration, if relevant */
+    bytes?: number;
+}
+
+export interface BenchmarkOptions {
+    /** Iterations that are timed */
+    iterations?: number;
+    /** Untimed iterations run first to warm up the JIT */
+    warmup?: number;
+    /** Bytes processed by one iteration, used to report throughput */
+    bytes?: number;
+}
+
+/**
+ * Pseudo random number generator (mulberry32), so that runs are
+ * reproducible.
+ */
+export function random(seed: number): () => number {
+    return () => {
+        seed = (seed + 0x6d2b79f5) | 0;
+        let t = Math.imul(seed ^ (seed >>> 15), 1 | seed);
+        t = (t + Math.imul(t ^ (t >>> 7), 61 | t)) ^ t;
+        return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+    };
+}
+
+export function formatBytes(bytes: number): string {
+    const units = ['B', 'KB', 'MB', 'GB'];
+    let unit = 0;
+    while (bytes >= 1024 && unit < units.length - 1) {
+        bytes /= 1024;
+        unit++;
+    }
+    return `${Number.isInteger(bytes) ? bytes : bytes.toFixed(1)} ${
+        units[unit]
+    }`;
+}
+
+function pad(text: string, width: number, left = false) {
+    const fill = ' '.repeat(Math.max(0, width - text.length));
+    return left ? fill + text : text + fill;
+}
+
+export function report(result: BenchmarkResult) {
+    let line =
+        `${pad(result.name, 40)} ${pad(result.mean.toFixed(3), 10, true)}` +
+        ` ms/op (min ${result.min.toFixed(3)} ms, ${result.iterations} runs)`;
+    if (result.bytes) {
+        const throughput = result.bytes / 1024 / 1024 / (result.min / 1000);
+        line += ` ${throughput.toFixed(1)} MB/s`;
+    }
+    console.log(line);
+}
+
+export async function bench(
+    name: string,
+    fn: () => void | Promise<void>,
+    options: BenchmarkOptions = {}
+): Promise<BenchmarkResult> {
+    const iterations = options.iterations ?? 10;
+    const warmup = options.warmup ?? 2;
+    for (let i = 0; i < warmup; i++) {
+        await fn();
+    }
+    let total = 0;
+    let min = Infinity;
+    for (let i = 0; i < iterations; i++) {
+        const start = performance.now();
+        await fn();
+        const elapsed = performance.now() - start;
+        total += elapsed;
+        min = Math.min(min, elapsed);
+    }
+    const result = {
+        name,
+        iterations,
+        mean: total / iterations,
+        min,
+        bytes: options.bytes,
+    };
+    report(result);
+    return result;
+}
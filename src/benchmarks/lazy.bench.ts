@@ -0,0 +1,170 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Compares eager and lazy decoding of large result records, accessing
+ * the fields the adapter uses: a 2,000 breakpoints -break-list, a 1 MB
+ * -data-read-memory-bytes and a 1,000 threads -thread-info.
+ *
+ * Run with --expose-gc to also report the heap used by the decoded
+ * results.
+ */
+
+import { GDBBackend } from '../GDBBackend';
+import { MIParser, MIResultOptions } from '../MIParser';
+import { loadNativeMIParser } from '../native/mi-parser';
+import { bench, formatBytes } from './harness';
+
+class BenchParser extends MIParser {
+    constructor(native: boolean) {
+        super({} as GDBBackend);
+        if (!native) {
+            this.nativeParser = undefined;
+        }
+    }
+
+    public decode(line: string, options?: MIResultOptions) {
+        let result: any;
+        this.queueCommand(
+            1,
+            (_resultClass, resultData) => (result = resultData),
+            options
+        );
+        this.parseLine(line);
+        return result;
+    }
+}
+
+function breakList(count: number) {
+    const body: string[] = [];
+    for (let i = 1; i <= count; i++) {
+        body.push(
+            `bkpt={number="${i}",type="breakpoint",disp="keep",enabled="y",` +
+                `addr="0x${(0x401000 + i * 16).toString(16)}",func="func${i}",` +
+                `file="file${i % 50}.c",fullname="/home/user/src/file${
+                    i % 50
+                }.c",line="${i}",thread-groups=["i1"],times="0",` +
+                `original-location="/home/user/src/file${i % 50}.c:${i}"}`
+        );
+    }
+    return (
+        '1^done,BreakpointTable={nr_rows="' +
+        count +
+        '",nr_cols="6",hdr=[{width="7",alignment="-1",col_name="number",colhdr="Num"}],' +
+        `body=[${body.join(',')}]}`
+    );
+}
+
+function readMemory(size: number) {
+    return (
+        '1^done,memory=[{begin="0x7ffff7dd0000",offset="0x0",end="0x' +
+        (0x7ffff7dd0000 + size).toString(16) +
+        `",contents="${'a5'.repeat(size)}"}]`
+    );
+}
+
+function threadInfo(count: number) {
+    const threads: string[] = [];
+    for (let i = 1; i <= count; i++) {
+        threads.push(
+            `{id="${i}",target-id="Thread 0x7ffff7d8${i} (LWP ${i})",` +
+                `name="worker${i}",frame={level="0",addr="0x401136",` +
+                `func="worker",args=[{name="arg",value="0x${i.toString(
+                    16
+                )}"}],file="worker.c",fullname="/home/user/src/worker.c",` +
+                `line="${i}",arch="i386:x86-64"},state="stopped",core="${
+                    i % 8
+                }"}`
+        );
+    }
+    return `1^done,threads=[${threads.join(',')}],current-thread-id="1"`;
+}
+
+/** Report the heap used by the decoded result, when gc is exposed */
+function reportHeap(name: string, decode: () => any) {
+    const gc = (global as any).gc;
+    if (!gc) {
+        return;
+    }
+    gc();
+    const before = process.memoryUsage().heapUsed;
+    const result = decode();
+    const after = process.memoryUsage().heapUsed;
+    if (result) {
+        console.log(`${name} heap: ${formatBytes(Math.max(0, after - before))}`);
+    }
+}
+
+interface Scenario {
+    name: string;
+    line: string;
+    options: MIResultOptions;
+    /** Access the fields the adapter uses, return what is kept */
+    use: (result: any) => any;
+}
+
+async function main() {
+    const scenarios: Scenario[] = [
+        {
+            name: '-break-list 2000',
+            line: breakList(2000),
+            options: { lazy: true },
+            // what setBreakPointsRequest looks at
+            use: (result) =>
+                result.BreakpointTable.body.filter(
+                    (bkpt: any) =>
+                        !bkpt.number.includes('.') &&
+                        bkpt['original-location'].startsWith(
+                            '/home/user/src/file1.c'
+                        )
+                ),
+        },
+        {
+            name: '-data-read-memory-bytes 1 MB',
+            line: readMemory(1024 * 1024),
+            options: { lazy: true },
+            use: (result) => result.memory[0].contents,
+        },
+        {
+            name: '-thread-info 1000',
+            line: threadInfo(1000),
+            options: { lazy: true },
+            // what threadsRequest looks at
+            use: (result) =>
+                result.threads.map(
+                    (thread: any) => `${thread.id} ${thread.name} ${thread.state}`
+                ),
+        },
+    ];
+
+    const native = !!loadNativeMIParser();
+    for (const scenario of scenarios) {
+        const modes: Array<[string, boolean, MIResultOptions | undefined]> = [
+            ['eager', false, undefined],
+            [Object.keys(scenario.options).join('+'), false, scenario.options],
+        ];
+        if (native) {
+            modes.push(['native', true, undefined]);
+        }
+        for (const [mode, useNative, options] of modes) {
+            const parser = new BenchParser(useNative);
+            const decode = () =>
+                scenario.use(parser.decode(scenario.line, options));
+            const name = `${scenario.name} ${mode}`;
+            await bench(name, decode, { bytes: scenario.line.length });
+            reportHeap(name, decode);
+        }
+    }
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exitCode = 1;
+});
@@ -0,0 +1,83 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Streams -var-list-children responses of 1 MB to 16 MB from a stand-in
+ * for gdb, through the socketpairs node gives child processes and through
+ * the pipes of the gdbPipeSize launch argument. The stand-in writes the
+ * response with cat, which blocks on a full pipe the way gdb does.
+ *
+ * Needs the native addon and Linux: yarn build, then yarn bench:pipe.
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { GDBBackend } from '../GDBBackend';
+import { writeFakeGdb } from '../integration-tests/fakeGdb';
+import { bench, formatBytes } from './harness';
+
+/** A -var-list-children result of about size bytes */
+function listChildren(size: number) {
+    const children: string[] = [];
+    let length = 0;
+    for (let i = 0; length < size; i++) {
+        const child =
+            `child={name="var1.[${i}]",exp="[${i}]",numchild="0",` +
+            `value="${i * 7}",type="int",thread-id="1"}`;
+        children.push(child);
+        length += child.length + 1;
+    }
+    return `^done,numchild="${children.length}",children=[${children.join(
+        ','
+    )}],has_more="0"\n`;
+}
+
+async function main() {
+    const dir = fs.mkdtempSync(path.join(os.tmpdir(), 'pipe-bench-'));
+    const record = path.join(dir, 'record');
+    const gdb = path.join(dir, 'gdb');
+    writeFakeGdb(gdb, { '*-var-list-children*': `cat "${record}"` });
+    try {
+        for (const size of [1, 4, 16].map((mb) => mb * 1024 * 1024)) {
+            fs.writeFileSync(record, listChildren(size));
+            for (const gdbPipeSize of [0, 1024 * 1024]) {
+                const backend = new GDBBackend();
+                await backend.spawn({
+                    gdb,
+                    cwd: dir,
+                    program: '',
+                    gdbPipeSize,
+                });
+                await bench(
+                    `${formatBytes(size)} response, ${
+                        gdbPipeSize ? formatBytes(gdbPipeSize) : 'default'
+                    } pipes`,
+                    async () => {
+                        // lazily, to time the transport more than decoding
+                        await backend.sendCommand(
+                            '-var-list-children --all-values var1',
+                            { lazy: true }
+                        );
+                    },
+                    { iterations: 10, bytes: size }
+                );
+                backend.kill();
+            }
+        }
+    } finally {
+        fs.rmSync(dir, { recursive: true, force: true });
+    }
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exitCode = 1;
+});
@@ -0,0 +1,169 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Times the stackTrace, variables and disassemble requests of
+ * GDBDebugSession against MI traffic recorded with the `recordMI` launch
+ * argument, so that no gdb is needed:
+ *
+ *   yarn bench:replay path/to/session.mirec
+ *
+ * The requests are made with the arguments found in the recording, the
+ * first stack trace and disassembly the recorded session asked for.
+ */
+
+import { DebugProtocol } from '@vscode/debugprotocol';
+import { GDBBackend } from '../GDBBackend';
+import { GDBDebugSession, LaunchRequestArguments } from '../GDBDebugSession';
+import { MIReplayBackend } from '../miReplayBackend';
+import { MIRecording, MITraceDirection, readMIRecording } from '../miTrace';
+import { bench } from './harness';
+
+// createBackend is called while GDBDebugSession is constructed
+let recording: MIRecording;
+
+class ReplaySession extends GDBDebugSession {
+    protected seq = 1;
+    protected pending = new Map<
+        number,
+        (response: DebugProtocol.Response) => void
+    >();
+
+    get backend() {
+        return this.gdb as MIReplayBackend;
+    }
+
+    protected createBackend(): GDBBackend {
+        return new MIReplayBackend(recording);
+    }
+
+    public request(command: string, args?: any) {
+        return new Promise<DebugProtocol.Response>((resolve) => {
+            const seq = this.seq++;
+            this.pending.set(seq, resolve);
+            this.dispatchRequest({
+                seq,
+                type: 'request',
+                command,
+                arguments: args,
+            });
+        });
+    }
+
+    public sendResponse(response: DebugProtocol.Response): void {
+        const resolve = this.pending.get(response.request_seq);
+        this.pending.delete(response.request_seq);
+        resolve?.(response);
+    }
+
+    public sendEvent(_event: DebugProtocol.Event): void {
+        // nobody is listening
+    }
+}
+
+/** Arguments of the first recorded command matching regex */
+function findCommand(regex: RegExp) {
+    for (const entry of recording.entries) {
+        if (entry.direction === MITraceDirection.Out) {
+            const match = regex.exec(entry.data.toString());
+            if (match) {
+                return match;
+            }
+        }
+    }
+    return undefined;
+}
+
+async function timeRequest(
+    session: ReplaySession,
+    command: string,
+    args: any
+) {
+    const misses = session.backend.misses.length;
+    const response = await session.request(command, args);
+    if (!response.success) {
+        console.log(`${command} failed: ${response.message}`);
+        return;
+    }
+    await bench(command, async () => {
+        await session.request(command, args);
+    });
+    const missed = session.backend.misses.slice(misses);
+    if (missed.length) {
+        console.log(
+            `  ${missed.length} commands were not in the recording, ` +
+                `e.g. ${missed[0]}`
+        );
+    }
+}
+
+async function main() {
+    const file = process.argv[2];
+    if (!file) {
+        console.log('usage: replay.bench.ts <recording>');
+        process.exit(1);
+    }
+    recording = readMIRecording(file);
+    console.log(
+        `${recording.entries.length} MI records, gdb ${
+            recording.metadata.gdbVersion ?? 'unknown'
+        }`
+    );
+
+    const session = new ReplaySession();
+    await session.backend.spawn({ program: '' } as LaunchRequestArguments);
+
+    const frames = findCommand(
+        /^-stack-list-frames --thread (\d+) (\d+) (\d+)$/
+    );
+    if (frames) {
+        const startFrame = parseInt(frames[2], 10);
+        const stackTraceArgs: DebugProtocol.StackTraceArguments = {
+            threadId: parseInt(frames[1], 10),
+            startFrame,
+            levels: parseInt(frames[3], 10) - startFrame + 1,
+        };
+        await timeRequest(session, 'stackTrace', stackTraceArgs);
+
+        const stackTrace = (await session.request(
+            'stackTrace',
+            stackTraceArgs
+        )) as DebugProtocol.StackTraceResponse;
+        const frame = stackTrace.body?.stackFrames[0];
+        if (frame) {
+            const scopes = (await session.request('scopes', {
+                frameId: frame.id,
+            })) as DebugProtocol.ScopesResponse;
+            await timeRequest(session, 'variables', {
+                variablesReference: scopes.body.scopes[0].variablesReference,
+            });
+        }
+    } else {
+        console.log('No stack trace in the recording');
+    }
+
+    const disassemble = findCommand(
+        /^-data-disassemble -s "\((.*)\)\+0" -e "\(\1\)\+0\+(\d+)"/
+    );
+    if (disassemble) {
+        await timeRequest(session, 'disassemble', {
+            memoryReference: disassemble[1],
+            // see the mean size of instructions in disassembleRequest
+            instructionCount: parseInt(disassemble[2], 10) / 4,
+        });
+    } else {
+        console.log('No disassembly in the recording');
+    }
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
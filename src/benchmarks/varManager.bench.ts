@@ -0,0 +1,190 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Adds 10,000 varobjs to one frame of VarManager, looks each of them up
+ * by expression and by varname, then removes them all, against a gdb
+ * that answers at once. The array based VarManager that was replaced is
+ * measured too, for comparison.
+ */
+
+import { GDBBackend } from '../GDBBackend';
+import { MIVarCreateResponse, sendVarDelete } from '../mi/var';
+import { VarManager, VarObjType } from '../varManager';
+import { bench } from './harness';
+
+const gdb = {
+    sendCommand: () => Promise.resolve({}),
+} as unknown as GDBBackend;
+
+/** How VarManager stored varobjs before they were indexed */
+class LegacyVarManager {
+    protected readonly variableMap = new Map<string, VarObjType[]>();
+
+    public getKey(threadId: number, frameKey: string): string {
+        return `thread${threadId}_frame${frameKey}`;
+    }
+
+    public getVar(
+        threadId: number,
+        frameKey: string,
+        expression: string,
+        type?: string
+    ): VarObjType | undefined {
+        const vars = this.variableMap.get(this.getKey(threadId, frameKey));
+        if (vars) {
+            for (const varobj of vars) {
+                if (varobj.expression === expression) {
+                    if (type !== 'registers') {
+                        type = 'local';
+                    }
+                    if (type === varobj.varType) {
+                        return varobj;
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    public getVarByName(
+        threadId: number,
+        frameKey: string,
+        varname: string
+    ): VarObjType | undefined {
+        const vars = this.variableMap.get(this.getKey(threadId, frameKey));
+        return vars?.find((varobj) => varobj.varname === varname);
+    }
+
+    public addVar(
+        threadId: number,
+        frameKey: string,
+        expression: string,
+        isVar: boolean,
+        isChild: boolean,
+        varCreateResponse: MIVarCreateResponse
+    ): VarObjType {
+        const key = this.getKey(threadId, frameKey);
+        let vars = this.variableMap.get(key);
+        if (!vars) {
+            vars = [];
+            this.variableMap.set(key, vars);
+        }
+        const varobj: VarObjType = {
+            varname: varCreateResponse.name,
+            expression,
+            numchild: varCreateResponse.numchild,
+            children: [],
+            value: varCreateResponse.value,
+            type: varCreateResponse.type,
+            isVar,
+            isChild,
+            varType: 'local',
+        };
+        vars.push(varobj);
+        return varobj;
+    }
+
+    public async removeVar(
+        threadId: number,
+        frameKey: string,
+        varname: string
+    ): Promise<void> {
+        const vars = this.variableMap.get(this.getKey(threadId, frameKey));
+        const deleteme = vars?.find((varobj) => varobj.varname === varname);
+        if (vars && deleteme) {
+            await sendVarDelete(gdb, { varname: deleteme.varname });
+            vars.splice(vars.indexOf(deleteme), 1);
+        }
+    }
+}
+
+type Manager = Pick<
+    VarManager,
+    'getVar' | 'getVarByName' | 'addVar' | 'removeVar'
+>;
+
+const COUNT = 10000;
+
+function responses(): MIVarCreateResponse[] {
+    const result: MIVarCreateResponse[] = [];
+    for (let i = 0; i < COUNT; i++) {
+        result.push({
+            name: `var${i + 1}`,
+            numchild: '0',
+            value: `${i}`,
+            type: 'int',
+            'thread-id': '1',
+            has_more: '0',
+        } as MIVarCreateResponse);
+    }
+    return result;
+}
+
+async function run(name: string, create: () => Manager) {
+    const created = responses();
+    let manager = create();
+    await bench(
+        `${name} add ${COUNT}`,
+        () => {
+            manager = create();
+            created.forEach((response, i) =>
+                manager.addVar(1, 'f', `local${i}`, true, false, response)
+            );
+        },
+        { iterations: 10 }
+    );
+    await bench(
+        `${name} getVar ${COUNT}`,
+        () => {
+            for (let i = 0; i < COUNT; i++) {
+                if (!manager.getVar(1, 'f', `local${i}`)) {
+                    throw new Error(`local${i} not found`);
+                }
+            }
+        },
+        { iterations: 5 }
+    );
+    await bench(
+        `${name} getVarByName ${COUNT}`,
+        () => {
+            for (let i = 0; i < COUNT; i++) {
+                if (!manager.getVarByName(1, 'f', `var${i + 1}`)) {
+                    throw new Error(`var${i + 1} not found`);
+                }
+            }
+        },
+        { iterations: 5 }
+    );
+    await bench(
+        `${name} removeVar ${COUNT}`,
+        async () => {
+            manager = create();
+            created.forEach((response, i) =>
+                manager.addVar(1, 'f', `local${i}`, true, false, response)
+            );
+            // from the oldest, like out of scope locals
+            for (let i = 0; i < COUNT; i++) {
+                await manager.removeVar(1, 'f', `var${i + 1}`);
+            }
+        },
+        { iterations: 3, warmup: 1 }
+    );
+}
+
+async function main() {
+    await run('VarManager', () => new VarManager(gdb));
+    await run('legacy VarManager', () => new LegacyVarManager());
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exitCode = 1;
+});
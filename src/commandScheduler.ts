@@ -0,0 +1,160 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { AsyncLocalStorage } from 'async_hooks';
+
+/**
+ * The order in which queued commands are written to gdb, most urgent
+ * first.
+ */
+export enum CommandPriority {
+    /** Running, stepping, interrupting and ending the session */
+    RunControl = 0,
+    /** Queries the user is waiting for */
+    Interactive = 1,
+    /** Prefetching that nobody is waiting for yet */
+    Background = 2,
+}
+
+const runControlCommands = new Set([
+    '-gdb-exit',
+    '-target-detach',
+    '-target-disconnect',
+]);
+
+/** The priority of a command that did not ask for one */
+export function commandPriority(command: string): CommandPriority {
+    if (command.startsWith('-exec-')) {
+        return CommandPriority.RunControl;
+    }
+    const end = command.indexOf(' ');
+    return runControlCommands.has(end === -1 ? command : command.slice(0, end))
+        ? CommandPriority.RunControl
+        : CommandPriority.Interactive;
+}
+
+/** The DAP request on behalf of which commands are sent */
+export interface RequestContext {
+    seq: number;
+    cancelled: boolean;
+    /** Whether commands sent on behalf of this are for request too */
+    serves?(request: RequestContext): boolean;
+}
+
+/**
+ * The request being handled, set by the session for the whole handling of
+ * each request, including what runs after awaiting results.
+ */
+export const requestContext = new AsyncLocalStorage<RequestContext>();
+
+/** The error of commands dropped because their request was cancelled */
+export function cancelledError() {
+    return new Error('cancelled');
+}
+
+export interface ScheduledCommand {
+    command: string;
+    priority: CommandPriority;
+    request?: RequestContext;
+    /** Write the command to gdb */
+    send(): void;
+    /** Fail the command without sending it */
+    drop(error: Error): void;
+}
+
+/**
+ * Commands waiting to be written to gdb, one FIFO queue per priority.
+ */
+export class CommandScheduler {
+    protected queues: ScheduledCommand[][] = [[], [], []];
+    // index of the first command still waiting in each queue
+    protected heads = [0, 0, 0];
+    protected count = 0;
+    protected dropped = 0;
+
+    get size() {
+        return this.count;
+    }
+
+    /** Commands dropped because their request was cancelled */
+    get cancelled() {
+        return this.dropped;
+    }
+
+    public push(command: ScheduledCommand) {
+        this.queues[command.priority].push(command);
+        this.count++;
+    }
+
+    /**
+     * The most urgent command, oldest first. Commands of cancelled requests
+     * are dropped on the way.
+     */
+    public shift(): ScheduledCommand | undefined {
+        for (let priority = 0; priority < this.queues.length; priority++) {
+            // compact() replaces the queue, read it again on each command
+            while (this.heads[priority] < this.queues[priority].length) {
+                const command = this.queues[priority][this.heads[priority]++];
+                this.count--;
+                this.compact(priority);
+                if (command.request?.cancelled) {
+                    this.dropped++;
+                    command.drop(cancelledError());
+                } else {
+                    return command;
+                }
+            }
+        }
+        return undefined;
+    }
+
+    /**
+     * Drop the commands of a request that was cancelled, and the commands
+     * it shares with other requests once they are all cancelled.
+     *
+     * @returns how many commands were dropped
+     */
+    public cancel(request: RequestContext): number {
+        let dropped = 0;
+        for (let priority = 0; priority < this.queues.length; priority++) {
+            const queue = this.queues[priority];
+            const kept: ScheduledCommand[] = [];
+            for (let i = this.heads[priority]; i < queue.length; i++) {
+                const owner = queue[i].request;
+                if (
+                    owner === request ||
+                    (owner?.serves?.(request) && owner.cancelled)
+                ) {
+                    dropped++;
+                    queue[i].drop(cancelledError());
+                } else {
+                    kept.push(queue[i]);
+                }
+            }
+            this.queues[priority] = kept;
+            this.heads[priority] = 0;
+        }
+        this.count -= dropped;
+        this.dropped += dropped;
+        return dropped;
+    }
+
+    // drop the commands already shifted once they are most of the queue
+    protected compact(priority: number) {
+        const head = this.heads[priority];
+        const queue = this.queues[priority];
+        if (head === queue.length) {
+            this.queues[priority] = [];
+            this.heads[priority] = 0;
+        } else if (head > 64 && head * 2 > queue.length) {
+            this.queues[priority] = queue.slice(head);
+            this.heads[priority] = 0;
+        }
+    }
+}
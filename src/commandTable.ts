@@ -0,0 +1,176 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { performance } from 'perf_hooks';
+import { MIResultOptions } from './MIParser';
+
+export type CommandCallback = (resultClass: string, resultData: any) => void;
+
+export interface PendingCommand {
+    token: number;
+    callback: CommandCallback;
+    options?: MIResultOptions;
+    /** The command, for timeout messages */
+    command?: string;
+    /** performance.now() when the command was queued */
+    sent: number;
+    timer?: NodeJS.Timeout;
+    /** The command failed with a timeout, its result is ignored */
+    timedOut?: boolean;
+}
+
+export interface CommandStats {
+    /** Commands waiting for their result */
+    outstanding: number;
+    /** Time the oldest outstanding command has been waiting, in ms */
+    oldestOutstanding: number;
+    /** Commands whose result was received */
+    completed: number;
+    timedOut: number;
+    /** Time from queuing a command to receiving its result, in ms */
+    meanLatency: number;
+    maxLatency: number;
+}
+
+/**
+ * The commands sent to gdb that are waiting for their result, by token.
+ *
+ * Tokens are allocated sequentially, so the outstanding ones are stored
+ * in a ring indexed by the low bits of the token. A command whose slot is
+ * still taken, because more commands than the ring holds are outstanding,
+ * goes to a Map instead.
+ */
+export class CommandTable {
+    protected ring: Array<PendingCommand | undefined>;
+    protected mask: number;
+    protected overflow = new Map<number, PendingCommand>();
+    protected count = 0;
+    // commands with result options, so the parser can skip looking them up
+    protected withOptions = 0;
+
+    protected completed = 0;
+    protected timedOut = 0;
+    protected totalLatency = 0;
+    protected maxLatency = 0;
+
+    /**
+     * @param capacity the size of the ring, rounded up to a power of two
+     */
+    constructor(capacity = 256) {
+        let size = 1;
+        while (size < capacity) {
+            size *= 2;
+        }
+        this.ring = new Array(size);
+        this.mask = size - 1;
+    }
+
+    get size() {
+        return this.count;
+    }
+
+    /** Whether some outstanding commands have result options */
+    get hasOptions() {
+        return this.withOptions > 0;
+    }
+
+    public add(command: PendingCommand) {
+        const slot = command.token & this.mask;
+        if (this.ring[slot] === undefined) {
+            this.ring[slot] = command;
+        } else {
+            this.overflow.set(command.token, command);
+        }
+        this.count++;
+        if (command.options) {
+            this.withOptions++;
+        }
+    }
+
+    public get(token: number): PendingCommand | undefined {
+        const command = this.ring[token & this.mask];
+        if (command && command.token === token) {
+            return command;
+        }
+        return this.overflow.size ? this.overflow.get(token) : undefined;
+    }
+
+    /**
+     * Remove the command with this token and account for its completion.
+     */
+    public take(token: number): PendingCommand | undefined {
+        const slot = token & this.mask;
+        let command = this.ring[slot];
+        if (command && command.token === token) {
+            this.ring[slot] = undefined;
+        } else {
+            command = this.overflow.size
+                ? this.overflow.get(token)
+                : undefined;
+            if (!command) {
+                return undefined;
+            }
+            this.overflow.delete(token);
+        }
+        this.count--;
+        if (command.options) {
+            this.withOptions--;
+        }
+        if (command.timer) {
+            clearTimeout(command.timer);
+        }
+        const latency = performance.now() - command.sent;
+        this.completed++;
+        this.totalLatency += latency;
+        this.maxLatency = Math.max(this.maxLatency, latency);
+        return command;
+    }
+
+    /**
+     * Fail the command with an error result if it has not completed after
+     * timeout ms. It stays outstanding until gdb replies, then its result
+     * is dropped.
+     */
+    public setTimeout(command: PendingCommand, timeout: number) {
+        command.timer = setTimeout(() => {
+            command.timer = undefined;
+            command.timedOut = true;
+            this.timedOut++;
+            command.callback('error', {
+                msg: `Timed out after ${timeout} ms waiting for the result of ${
+                    command.command ?? command.token
+                }`,
+            });
+        }, timeout);
+        command.timer.unref();
+    }
+
+    public stats(): CommandStats {
+        const now = performance.now();
+        let oldest = now;
+        for (const command of this.ring) {
+            if (command && command.sent < oldest) {
+                oldest = command.sent;
+            }
+        }
+        for (const command of this.overflow.values()) {
+            oldest = Math.min(oldest, command.sent);
+        }
+        return {
+            outstanding: this.count,
+            oldestOutstanding: now - oldest,
+            completed: this.completed,
+            timedOut: this.timedOut,
+            meanLatency: this.completed
+                ? this.totalLatency / this.completed
+                : 0,
+            maxLatency: this.maxLatency,
+        };
+    }
+}
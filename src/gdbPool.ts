@@ -0,0 +1,187 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { performance } from 'perf_hooks';
+import { logger } from '@vscode/debugadapter/lib/logger';
+import { requestContext } from './commandScheduler';
+import { GDBBackend } from './GDBBackend';
+import {
+    AttachRequestArguments,
+    LaunchRequestArguments,
+} from './GDBDebugSession';
+import { getGdbCwd } from './util';
+
+export interface GDBPoolStats {
+    /** gdb processes started ahead of time and not claimed yet */
+    idle: number;
+    /** Launches that claimed a pooled gdb */
+    warmStarts: number;
+    /** Launches with the pool enabled that had to start their own gdb */
+    coldStarts: number;
+    /** Mean time to start and configure a gdb, in ms */
+    meanColdStart: number;
+    /** Mean time for a launch to claim a pooled gdb, in ms */
+    meanWarmStart: number;
+    /** Launch time saved by claiming pooled gdbs, in ms */
+    saved: number;
+}
+
+interface PooledGDB {
+    key: string;
+    backend: GDBBackend;
+    /** Resolves to whether gdb started and was configured */
+    ready: Promise<boolean>;
+}
+
+/**
+ * gdb processes can only be shared between launches that would start
+ * and configure them the same way.
+ */
+export function poolKey(
+    requestArgs: LaunchRequestArguments | AttachRequestArguments
+): string {
+    return JSON.stringify([
+        requestArgs.gdb || 'gdb',
+        requestArgs.gdbArguments ?? [],
+        getGdbCwd(requestArgs),
+        requestArgs.environment ?? {},
+        !!requestArgs.gdbNonStop,
+        requestArgs.gdbAsync ?? true,
+        requestArgs.indexCache ?? false,
+        requestArgs.gdbPipeSize ?? 0,
+    ]);
+}
+
+/**
+ * Idle gdb processes, started and configured ahead of the launches that
+ * will claim them. This pays off when one adapter process runs many
+ * sessions, as with the --server option.
+ */
+export class GDBPool {
+    protected idle: PooledGDB[] = [];
+    protected warmStarts = 0;
+    protected warmTime = 0;
+    protected coldStarts = 0;
+    // samples of starting gdb, from cold launches and from filling the pool
+    protected coldSamples = 0;
+    protected coldTime = 0;
+    protected killOnExit = false;
+
+    /**
+     * Take an idle gdb started for the same arguments, waiting for it to
+     * be ready if it is still starting.
+     */
+    public async claim(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ): Promise<GDBBackend | undefined> {
+        const key = poolKey(requestArgs);
+        for (;;) {
+            const index = this.idle.findIndex((pooled) => pooled.key === key);
+            if (index === -1) {
+                return undefined;
+            }
+            const [pooled] = this.idle.splice(index, 1);
+            if ((await pooled.ready) && !pooled.backend.isExited()) {
+                return pooled.backend;
+            }
+        }
+    }
+
+    /**
+     * Start gdbs in the background until size of them are idle for these
+     * arguments.
+     */
+    public fill(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments,
+        size: number,
+        create: () => GDBBackend
+    ) {
+        const key = poolKey(requestArgs);
+        const warmArgs = {
+            ...requestArgs,
+            gdbPoolSize: 0,
+            recordMI: undefined,
+        };
+        let count = this.idle.filter((pooled) => pooled.key === key).length;
+        for (; count < size; count++) {
+            const backend = create();
+            const start = performance.now();
+            // the pooled gdb does not belong to the request that filled it
+            const ready = requestContext.exit(() =>
+                backend.spawn(warmArgs).then(
+                    () => {
+                        this.coldSamples++;
+                        this.coldTime += performance.now() - start;
+                        return true;
+                    },
+                    (err) => {
+                        logger.verbose(
+                            `Could not start a pooled gdb: ${
+                                err instanceof Error ? err.message : String(err)
+                            }`
+                        );
+                        backend.kill();
+                        this.idle = this.idle.filter(
+                            (pooled) => pooled.backend !== backend
+                        );
+                        return false;
+                    }
+                )
+            );
+            this.idle.push({ key, backend, ready });
+        }
+        if (!this.killOnExit && this.idle.length) {
+            this.killOnExit = true;
+            process.once('exit', () => this.drain());
+        }
+    }
+
+    /** Account for a launch, warm if it claimed a pooled gdb */
+    public recordLaunch(warm: boolean, time: number) {
+        if (warm) {
+            this.warmStarts++;
+            this.warmTime += time;
+        } else {
+            this.coldStarts++;
+            this.coldSamples++;
+            this.coldTime += time;
+        }
+    }
+
+    /** Stop all the idle gdbs */
+    public drain() {
+        for (const pooled of this.idle) {
+            pooled.backend.kill();
+        }
+        this.idle = [];
+    }
+
+    public stats(): GDBPoolStats {
+        const meanColdStart = this.coldSamples
+            ? this.coldTime / this.coldSamples
+            : 0;
+        const meanWarmStart = this.warmStarts
+            ? this.warmTime / this.warmStarts
+            : 0;
+        return {
+            idle: this.idle.length,
+            warmStarts: this.warmStarts,
+            coldStarts: this.coldStarts,
+            meanColdStart,
+            meanWarmStart,
+            saved: Math.max(
+                0,
+                this.warmStarts * meanColdStart - this.warmTime
+            ),
+        };
+    }
+}
+
+/** The pool shared by the sessions of this process */
+export const gdbPool = new GDBPool();
@@ -0,0 +1,229 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { promises as fs, Stats } from 'fs';
+import { homedir, platform } from 'os';
+import * as path from 'path';
+import { logger } from '@vscode/debugadapter/lib/logger';
+
+/** What is known about a gdb executable */
+export interface GdbProbe {
+    /** As returned by getGdbVersion */
+    version?: string;
+    /** The result of -list-features */
+    features?: string[];
+    /** Whether gdb was built with Python support */
+    python?: boolean;
+}
+
+interface GdbProbeEntry extends GdbProbe {
+    ino: number;
+    mtime: number;
+    size: number;
+}
+
+const CACHE_VERSION = 1;
+
+/** The per-user cache directory, $XDG_CACHE_HOME or its equivalent */
+export function userCacheDir() {
+    return platform() === 'win32'
+        ? process.env.LOCALAPPDATA || path.join(homedir(), 'AppData', 'Local')
+        : process.env.XDG_CACHE_HOME || path.join(homedir(), '.cache');
+}
+
+/**
+ * Replace file with data at once, so that other adapters reading it
+ * meanwhile never see it half written. Nothing is left behind if it
+ * cannot be written.
+ */
+export async function writeCacheFile(file: string, data: string) {
+    await fs.mkdir(path.dirname(file), { recursive: true });
+    const temp = `${file}.${process.pid}.tmp`;
+    try {
+        await fs.writeFile(temp, data);
+        await fs.rename(temp, file);
+    } catch (err) {
+        await fs.unlink(temp).catch(() => undefined);
+        throw err;
+    }
+}
+
+function defaultCacheFile() {
+    return path.join(userCacheDir(), 'cdt-gdb-adapter', 'gdb-probes.json');
+}
+
+/**
+ * The absolute path of the executable that running command would start,
+ * searching PATH like the shell if command has no directory.
+ */
+export async function resolveExecutable(
+    command: string,
+    cwd?: string,
+    env: NodeJS.ProcessEnv = process.env
+): Promise<string | undefined> {
+    const isWindows = platform() === 'win32';
+    const extensions = isWindows
+        ? ['', ...(env.PATHEXT || '.EXE;.CMD;.BAT').split(';')]
+        : [''];
+    const dirs =
+        path.basename(command) !== command
+            ? [cwd || process.cwd()]
+            : (env.PATH ?? env.Path ?? '').split(path.delimiter);
+    for (const dir of dirs) {
+        if (!dir) {
+            continue;
+        }
+        for (const extension of extensions) {
+            const candidate = path.resolve(dir, command + extension);
+            try {
+                if ((await fs.stat(candidate)).isFile()) {
+                    return candidate;
+                }
+            } catch {
+                // not there, keep looking
+            }
+        }
+    }
+    return undefined;
+}
+
+/**
+ * Results of probing gdb executables, kept on disk across sessions so
+ * that starting gdb does not need extra gdb processes or commands.
+ *
+ * Entries are keyed by the resolved path of gdb and are only used while
+ * its inode, modification time and size are the ones that were probed, so
+ * that an upgraded gdb is probed again.
+ */
+export class GdbProbeCache {
+    protected entries?: Record<string, GdbProbeEntry>;
+    protected loading?: Promise<Record<string, GdbProbeEntry>>;
+
+    constructor(public readonly file = defaultCacheFile()) {}
+
+    public async lookup(
+        gdbPath: string,
+        cwd?: string,
+        env?: NodeJS.ProcessEnv
+    ): Promise<GdbProbe | undefined> {
+        const target = await this.identify(gdbPath, cwd, env);
+        if (!target) {
+            return undefined;
+        }
+        const entry = (await this.load())[target.path];
+        if (
+            !entry ||
+            entry.ino !== target.stats.ino ||
+            entry.mtime !== target.stats.mtimeMs ||
+            entry.size !== target.stats.size
+        ) {
+            return undefined;
+        }
+        return entry;
+    }
+
+    /**
+     * Merge probe into what is known about gdbPath and save the cache.
+     * Failing to save is not an error, gdb is probed again next time.
+     */
+    public async store(
+        gdbPath: string,
+        cwd: string | undefined,
+        env: NodeJS.ProcessEnv | undefined,
+        probe: GdbProbe
+    ) {
+        const target = await this.identify(gdbPath, cwd, env);
+        if (!target) {
+            return;
+        }
+        // pick up what other adapters saved since it was loaded
+        this.entries = undefined;
+        this.loading = undefined;
+        const entries = await this.load();
+        const previous = entries[target.path];
+        const current =
+            previous &&
+            previous.ino === target.stats.ino &&
+            previous.mtime === target.stats.mtimeMs &&
+            previous.size === target.stats.size
+                ? previous
+                : undefined;
+        entries[target.path] = {
+            ...current,
+            ...probe,
+            ino: target.stats.ino,
+            mtime: target.stats.mtimeMs,
+            size: target.stats.size,
+        };
+        try {
+            await writeCacheFile(
+                this.file,
+                JSON.stringify({ version: CACHE_VERSION, entries })
+            );
+        } catch (err) {
+            logger.verbose(
+                `Could not save the gdb probe cache ${this.file}: ${
+                    err instanceof Error ? err.message : String(err)
+                }`
+            );
+        }
+    }
+
+    protected async identify(
+        gdbPath: string,
+        cwd?: string,
+        env?: NodeJS.ProcessEnv
+    ): Promise<{ path: string; stats: Stats } | undefined> {
+        const resolved = await resolveExecutable(gdbPath, cwd, env);
+        if (!resolved) {
+            return undefined;
+        }
+        try {
+            return { path: resolved, stats: await fs.stat(resolved) };
+        } catch {
+            return undefined;
+        }
+    }
+
+    protected load(): Promise<Record<string, GdbProbeEntry>> {
+        if (this.entries) {
+            return Promise.resolve(this.entries);
+        }
+        if (!this.loading) {
+            this.loading = fs
+                .readFile(this.file, 'utf8')
+                .then((data) => {
+                    const cache = JSON.parse(data);
+                    return cache?.version === CACHE_VERSION &&
+                        typeof cache.entries === 'object'
+                        ? cache.entries
+                        : {};
+                })
+                .catch(() => ({}))
+                .then((entries) => (this.entries = entries));
+        }
+        return this.loading;
+    }
+}
+
+/** The cache shared by the sessions of this process */
+export const gdbProbeCache = new GdbProbeCache();
+
+/** Set to any value to neither read nor write the probe cache */
+export const NO_PROBE_CACHE_VARIABLE = 'CDT_GDB_ADAPTER_NO_PROBE_CACHE';
+
+/**
+ * The probe cache to use, or undefined if the gdbProbeCache launch
+ * argument or the environment of the adapter turn it off.
+ */
+export function probeCache(enabled = true): GdbProbeCache | undefined {
+    return enabled && !process.env[NO_PROBE_CACHE_VARIABLE]
+        ? gdbProbeCache
+        : undefined;
+}
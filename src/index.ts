@@ -12,3 +12,5 @@ export * from './mi';
 export * from './GDBBackend';
 export * from './GDBDebugSession';
 export * from './GDBTargetDebugSession';
+export * from './miTrace';
+export * from './miReplayBackend';
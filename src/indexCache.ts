@@ -0,0 +1,226 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { spawn } from 'child_process';
+import { promises as fs } from 'fs';
+import { homedir, platform } from 'os';
+import * as path from 'path';
+import { logger } from '@vscode/debugadapter/lib/logger';
+import { userCacheDir, writeCacheFile } from './gdbProbeCache';
+import { compareVersions } from './util';
+
+/** What makes loading the symbols of a program fast */
+export interface SymbolIndexInfo {
+    /** The GNU build id, which names the entry in the index cache */
+    buildId?: string;
+    /** The program has a .gdb_index or .debug_names section */
+    hasIndex: boolean;
+}
+
+const NT_GNU_BUILD_ID = 3;
+
+/**
+ * Look for an index and the build id in the sections of an ELF file.
+ *
+ * @returns undefined if program is not an ELF file
+ */
+export async function readSymbolIndexInfo(
+    program: string
+): Promise<SymbolIndexInfo | undefined> {
+    const file = await fs.open(program, 'r');
+    try {
+        const read = async (position: number, length: number) => {
+            const buffer = Buffer.alloc(length);
+            const { bytesRead } = await file.read(buffer, 0, length, position);
+            return buffer.subarray(0, bytesRead);
+        };
+        const header = await read(0, 64);
+        if (
+            header.length < 52 ||
+            header.readUInt32BE(0) !== 0x7f454c46 // \x7fELF
+        ) {
+            return undefined;
+        }
+        const is64 = header[4] === 2;
+        const le = header[5] === 1;
+        const u16 = (b: Buffer, o: number) =>
+            le ? b.readUInt16LE(o) : b.readUInt16BE(o);
+        const u32 = (b: Buffer, o: number) =>
+            le ? b.readUInt32LE(o) : b.readUInt32BE(o);
+        const addr = (b: Buffer, o: number) =>
+            is64
+                ? le
+                    ? u32(b, o + 4) * 0x100000000 + u32(b, o)
+                    : u32(b, o) * 0x100000000 + u32(b, o + 4)
+                : u32(b, o);
+
+        const shoff = addr(header, is64 ? 0x28 : 0x20);
+        const shentsize = u16(header, is64 ? 0x3a : 0x2e);
+        const shnum = u16(header, is64 ? 0x3c : 0x30);
+        const shstrndx = u16(header, is64 ? 0x3e : 0x32);
+        const sections = await read(shoff, shentsize * shnum);
+        if (!shnum || sections.length < shentsize * shnum) {
+            return undefined;
+        }
+        const section = (index: number) => {
+            const base = index * shentsize;
+            return {
+                name: u32(sections, base),
+                offset: addr(sections, base + (is64 ? 0x18 : 0x10)),
+                size: addr(sections, base + (is64 ? 0x20 : 0x14)),
+            };
+        };
+        const strtab = section(shstrndx);
+        const names = await read(strtab.offset, strtab.size);
+
+        const info: SymbolIndexInfo = { hasIndex: false };
+        for (let i = 0; i < shnum; i++) {
+            const { name, offset, size } = section(i);
+            const end = names.indexOf(0, name);
+            const sectionName = names.toString('latin1', name, end);
+            if (
+                sectionName === '.gdb_index' ||
+                sectionName === '.debug_names'
+            ) {
+                info.hasIndex = true;
+            } else if (sectionName === '.note.gnu.build-id') {
+                const note = await read(offset, size);
+                const namesz = u32(note, 0);
+                const descsz = u32(note, 4);
+                const descStart = 12 + ((namesz + 3) & ~3);
+                if (u32(note, 8) === NT_GNU_BUILD_ID) {
+                    info.buildId = note.toString(
+                        'hex',
+                        descStart,
+                        descStart + descsz
+                    );
+                }
+            }
+        }
+        return info;
+    } finally {
+        await file.close();
+    }
+}
+
+/** Where gdb keeps its index cache unless told otherwise */
+export function defaultIndexCacheDir() {
+    if (platform() === 'darwin') {
+        return path.join(homedir(), 'Library', 'Caches', 'gdb');
+    }
+    return path.join(userCacheDir(), 'gdb');
+}
+
+/** The file gdb writes the index of the program with buildId to */
+export function indexCacheFile(directory: string, buildId: string) {
+    return path.join(directory, `${buildId}.gdb-index`);
+}
+
+/** The gdb command enabling the index cache, gdb 8.3 or newer */
+export function indexCacheCommand(gdbVersion: string) {
+    return compareVersions(gdbVersion, '12.1') >= 0
+        ? 'set index-cache enabled on'
+        : 'set index-cache on';
+}
+
+// build ids being indexed, so that each program is indexed once
+const generating = new Set<string>();
+
+/**
+ * Write the index of program to the index cache with a gdb in the
+ * background, so that the next loads of program are fast even if this
+ * session ends before its own gdb writes the index.
+ */
+export function generateIndex(
+    gdbPath: string,
+    gdbVersion: string,
+    program: string,
+    directory: string,
+    buildId: string,
+    options: { cwd?: string; env?: NodeJS.ProcessEnv }
+) {
+    if (generating.has(buildId)) {
+        return;
+    }
+    generating.add(buildId);
+    logger.verbose(`Generating the symbol index of ${program} in ${directory}`);
+    const proc = spawn(
+        gdbPath,
+        [
+            '-batch',
+            '-nx',
+            '-iex',
+            indexCacheCommand(gdbVersion),
+            '-iex',
+            `set index-cache directory ${directory}`,
+            program,
+        ],
+        { ...options, stdio: 'ignore' }
+    );
+    const done = () => generating.delete(buildId);
+    proc.on('error', (err) => {
+        logger.verbose(`Could not generate the index of ${program}: ${err}`);
+        done();
+    });
+    proc.on('exit', done);
+    // the adapter does not wait for it to exit
+    proc.unref();
+}
+
+/** The last symbol load times of a program, in ms */
+export interface SymbolLoadTimes {
+    /** Without an index */
+    cold?: number;
+    /** With an index, in the program or the index cache */
+    warm?: number;
+}
+
+/**
+ * Symbol load times by program, kept across sessions so that the cold
+ * load of the first session can be compared with the warm ones after.
+ */
+export class SymbolLoadHistory {
+    constructor(
+        public readonly file = path.join(
+            userCacheDir(),
+            'cdt-gdb-adapter',
+            'symbol-loads.json'
+        )
+    ) {}
+
+    public async read(): Promise<Record<string, SymbolLoadTimes>> {
+        try {
+            const history = JSON.parse(await fs.readFile(this.file, 'utf8'));
+            return typeof history === 'object' && history ? history : {};
+        } catch {
+            return {};
+        }
+    }
+
+    public async record(
+        program: string,
+        warm: boolean,
+        time: number
+    ): Promise<SymbolLoadTimes> {
+        const history = await this.read();
+        const times = history[program] ?? {};
+        if (warm) {
+            times.warm = time;
+        } else {
+            times.cold = time;
+        }
+        history[program] = times;
+        try {
+            await writeCacheFile(this.file, JSON.stringify(history));
+        } catch (err) {
+            logger.verbose(`Could not save ${this.file}: ${err}`);
+        }
+        return times;
+    }
+}
@@ -0,0 +1,152 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import {
+    CommandPriority,
+    commandPriority,
+    CommandScheduler,
+    RequestContext,
+    requestContext,
+} from '../commandScheduler';
+import { LaunchRequestArguments } from '../GDBDebugSession';
+import { MIReplayBackend } from '../miReplayBackend';
+import { MITraceDirection } from '../miTrace';
+
+class TestBackend extends MIReplayBackend {
+    public writes: string[] = [];
+
+    // reply later, like gdb, so that commands wait for the ones in flight
+    protected replay(data: string) {
+        this.writes.push(data);
+        setImmediate(() => super.replay(data));
+    }
+}
+
+describe('command scheduling', () => {
+    let backend: TestBackend;
+
+    beforeEach(async () => {
+        const traffic: Array<[MITraceDirection, number, string]> = [
+            [MITraceDirection.In, -1, '(gdb) '],
+            [MITraceDirection.Out, 0, '-gdb-set non-stop off'],
+            [MITraceDirection.In, 0, '0^done'],
+            [MITraceDirection.Out, 1, '-gdb-set mi-async on'],
+            [MITraceDirection.In, 1, '1^done'],
+            [MITraceDirection.Out, 2, '-var-list-children var1 0 100'],
+            [MITraceDirection.In, 2, '2^done,numchild="0"'],
+            [MITraceDirection.Out, 3, '-var-list-children var1 100 200'],
+            [MITraceDirection.In, 3, '3^done,numchild="0"'],
+            [MITraceDirection.Out, 4, '-exec-interrupt'],
+            [MITraceDirection.In, 4, '4^done'],
+            [MITraceDirection.Out, 5, '-thread-info'],
+            [MITraceDirection.In, 5, '5^done,threads=[]'],
+        ];
+        backend = new TestBackend({
+            metadata: { gdbVersion: '12.1' },
+            entries: traffic.map(([direction, token, data]) => ({
+                time: 0,
+                direction,
+                token,
+                data: Buffer.from(data),
+            })),
+        });
+        await backend.spawn({ program: '' } as LaunchRequestArguments);
+        backend.writes = [];
+        backend.maxCommandsInFlight = 1;
+    });
+
+    function written() {
+        return backend.writes.map((write) => write.replace(/^\d+/, ''));
+    }
+
+    it('classifies commands', () => {
+        expect(commandPriority('-exec-next --thread 1')).to.eq(
+            CommandPriority.RunControl
+        );
+        expect(commandPriority('-gdb-exit')).to.eq(CommandPriority.RunControl);
+        expect(commandPriority('-thread-info')).to.eq(
+            CommandPriority.Interactive
+        );
+    });
+
+    it('lets run control overtake queued queries', async () => {
+        const results = [
+            backend.sendCommand('-var-list-children var1 0 100', {
+                priority: CommandPriority.Background,
+            }),
+            backend.sendCommand('-var-list-children var1 100 200', {
+                priority: CommandPriority.Background,
+            }),
+            backend.sendCommand('-thread-info'),
+            backend.sendCommand('-exec-interrupt'),
+        ];
+        await Promise.all(results);
+        expect(written()).to.deep.eq([
+            '-var-list-children var1 0 100\n',
+            '-exec-interrupt\n',
+            '-thread-info\n',
+            '-var-list-children var1 100 200\n',
+        ]);
+    });
+
+    it('drops the unsent commands of a cancelled request', async () => {
+        const request: RequestContext = { seq: 7, cancelled: false };
+        const results = requestContext.run(request, () =>
+            backend.sendPipelined([
+                '-var-list-children var1 0 100',
+                '-var-list-children var1 100 200',
+            ])
+        );
+        const other = backend.sendCommand('-thread-info');
+        expect(backend.cancelCommands(request)).to.eq(1);
+
+        const [first, second] = await results;
+        expect(first.error).to.eq(undefined);
+        expect(second.error?.message).to.eq('cancelled');
+        expect(await other).to.deep.eq({ threads: [] });
+        expect(written()).to.deep.eq([
+            '-var-list-children var1 0 100\n',
+            '-thread-info\n',
+        ]);
+
+        // later commands of the request fail right away
+        let error: Error | undefined;
+        await requestContext
+            .run(request, () => backend.sendCommand('-thread-info'))
+            .catch((err) => (error = err));
+        expect(error?.message).to.eq('cancelled');
+        expect(backend.getCommandStats().cancelled).to.eq(1);
+    });
+
+    it('shifts each command once when the last queued one is cancelled', () => {
+        const scheduler = new CommandScheduler();
+        const request: RequestContext = { seq: 7, cancelled: false };
+        const sent: string[] = [];
+        const dropped: string[] = [];
+        for (const [command, owner] of [
+            ['A', undefined],
+            ['B', request],
+        ] as const) {
+            scheduler.push({
+                command,
+                priority: CommandPriority.Interactive,
+                request: owner,
+                send: () => sent.push(command),
+                drop: () => dropped.push(command),
+            });
+        }
+        scheduler.shift()?.send();
+        request.cancelled = true;
+        expect(scheduler.shift()).to.eq(undefined);
+        expect(sent).to.deep.eq(['A']);
+        expect(dropped).to.deep.eq(['B']);
+        expect(scheduler.size).to.eq(0);
+    });
+});
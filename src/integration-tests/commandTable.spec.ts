@@ -0,0 +1,103 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import { performance } from 'perf_hooks';
+import { CommandTable, PendingCommand } from '../commandTable';
+
+describe('CommandTable', () => {
+    let table: CommandTable;
+
+    beforeEach(() => {
+        table = new CommandTable(4);
+    });
+
+    function pending(token: number, options?: { lazy: boolean }) {
+        const command: PendingCommand = {
+            token,
+            callback: () => undefined,
+            options,
+            sent: performance.now(),
+        };
+        table.add(command);
+        return command;
+    }
+
+    it('finds commands by token', () => {
+        const commands = [pending(0), pending(1), pending(2)];
+        expect(table.size).to.eq(3);
+        expect(table.get(1)).to.eq(commands[1]);
+        expect(table.take(1)).to.eq(commands[1]);
+        expect(table.take(1)).to.eq(undefined);
+        expect(table.get(3)).to.eq(undefined);
+        expect(table.size).to.eq(2);
+    });
+
+    it('holds more commands than the ring', () => {
+        const commands: PendingCommand[] = [];
+        for (let token = 0; token < 10; token++) {
+            commands.push(pending(token));
+        }
+        expect(table.size).to.eq(10);
+        for (let token = 9; token >= 0; token--) {
+            expect(table.take(token)).to.eq(commands[token]);
+        }
+        expect(table.size).to.eq(0);
+        // slots are reused once free
+        const command = pending(12);
+        expect(table.take(12)).to.eq(command);
+    });
+
+    it('tracks the commands with result options', () => {
+        pending(0);
+        pending(1, { lazy: true });
+        expect(table.hasOptions).to.eq(true);
+        table.take(1);
+        expect(table.hasOptions).to.eq(false);
+    });
+
+    it('fails commands that time out', async () => {
+        const results: Array<[string, any]> = [];
+        const command = pending(0);
+        command.command = '-target-select remote :1234';
+        command.callback = (resultClass, resultData) =>
+            results.push([resultClass, resultData]);
+        table.setTimeout(command, 1);
+        await new Promise((resolve) => setTimeout(resolve, 20));
+
+        expect(results).to.deep.eq([
+            [
+                'error',
+                {
+                    msg: 'Timed out after 1 ms waiting for the result of -target-select remote :1234',
+                },
+            ],
+        ]);
+        expect(command.timedOut).to.eq(true);
+        expect(table.stats().timedOut).to.eq(1);
+        // still outstanding until gdb replies
+        expect(table.size).to.eq(1);
+        expect(table.take(0)).to.eq(command);
+    });
+
+    it('reports counts and latencies', async () => {
+        pending(0);
+        pending(1);
+        await new Promise((resolve) => setTimeout(resolve, 5));
+        table.take(0);
+
+        const stats = table.stats();
+        expect(stats.outstanding).to.eq(1);
+        expect(stats.completed).to.eq(1);
+        expect(stats.timedOut).to.eq(0);
+        expect(stats.meanLatency).to.be.greaterThan(1);
+        expect(stats.maxLatency).to.eq(stats.meanLatency);
+        expect(stats.oldestOutstanding).to.be.greaterThan(1);
+    });
+});
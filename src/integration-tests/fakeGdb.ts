@@ -0,0 +1,46 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+import * as fs from 'fs';
+
+/**
+ * Write a stand-in for gdb, for tests that need a gdb process but nothing
+ * to debug. It is a shell script that reports gdb 12.1 to --version and
+ * answers every MI command with ^done after its token.
+ *
+ * @param answers shell case patterns of commands, mapped to the shell
+ * commands that print the answer after the token instead
+ */
+export function writeFakeGdb(
+    file: string,
+    answers: { [pattern: string]: string } = {}
+) {
+    const cases = Object.keys(answers).map(
+        (pattern) =>
+            `    ${pattern})\n        ${answers[pattern]}\n        ;;\n`
+    );
+    const script = `#!/bin/sh
+if [ "$1" = "--version" ]; then
+    echo "GNU gdb (GDB) 12.1"
+    exit 0
+fi
+echo "(gdb) "
+while read -r line; do
+    printf '%s' "\${line%%[!0-9]*}"
+    case "$line" in
+${cases.join('')}    *)
+        echo "^done"
+        ;;
+    esac
+    echo "(gdb) "
+done
+`;
+    fs.writeFileSync(file, script, { mode: 0o755 });
+}
@@ -0,0 +1,75 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { GDBBackend } from '../GDBBackend';
+import { LaunchRequestArguments } from '../GDBDebugSession';
+import { gdbPool, poolKey } from '../gdbPool';
+import { writeFakeGdb } from './utils';
+
+describe('gdb pool', function () {
+    let dir: string;
+    let args: LaunchRequestArguments;
+    const backends: GDBBackend[] = [];
+
+    before(function () {
+        if (os.platform() === 'win32') {
+            this.skip();
+        }
+    });
+
+    beforeEach(() => {
+        dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gdb-pool-'));
+        const gdb = path.join(dir, 'gdb');
+        writeFakeGdb(gdb);
+        args = { gdb, cwd: dir, program: '', gdbPoolSize: 1 };
+    });
+
+    afterEach(() => {
+        gdbPool.drain();
+        backends.forEach((backend) => backend.kill());
+        fs.rmSync(dir, { recursive: true, force: true });
+    });
+
+    async function launch() {
+        const backend = new GDBBackend();
+        backends.push(backend);
+        await backend.spawn(args);
+        return backend;
+    }
+
+    it('only shares gdbs started the same way', () => {
+        expect(poolKey(args)).to.eq(poolKey({ ...args }));
+        expect(poolKey(args)).to.not.eq(
+            poolKey({ ...args, gdbArguments: ['-nx'] })
+        );
+        expect(poolKey(args)).to.not.eq(
+            poolKey({ ...args, environment: { FOO: 'bar' } })
+        );
+    });
+
+    it('claims a pooled gdb on the next launch', async () => {
+        const before = gdbPool.stats();
+        const cold = await launch();
+        expect(cold.isExited()).to.eq(false);
+        expect(gdbPool.stats().idle).to.eq(1);
+
+        const warm = await launch();
+        expect(await warm.sendCommand('-gdb-show version')).to.deep.eq({});
+
+        const stats = gdbPool.stats();
+        expect(stats.coldStarts - before.coldStarts).to.eq(1);
+        expect(stats.warmStarts - before.warmStarts).to.eq(1);
+        // refilled for the launch after
+        expect(stats.idle).to.eq(1);
+    });
+});
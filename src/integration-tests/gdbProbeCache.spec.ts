@@ -0,0 +1,109 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import {
+    GdbProbeCache,
+    gdbProbeCache,
+    NO_PROBE_CACHE_VARIABLE,
+    probeCache,
+    resolveExecutable,
+} from '../gdbProbeCache';
+
+describe('gdb probe cache', () => {
+    let dir: string;
+    let gdb: string;
+    let file: string;
+
+    beforeEach(() => {
+        dir = fs.mkdtempSync(path.join(os.tmpdir(), 'gdb-probes-'));
+        gdb = path.join(dir, 'gdb');
+        fs.writeFileSync(gdb, 'gdb 12.1');
+        file = path.join(dir, 'cache', 'gdb-probes.json');
+    });
+
+    afterEach(() => {
+        fs.rmSync(dir, { recursive: true, force: true });
+    });
+
+    it('finds executables on the PATH', async () => {
+        expect(await resolveExecutable('gdb', undefined, { PATH: dir })).to.eq(
+            gdb
+        );
+        expect(await resolveExecutable('./gdb', dir)).to.eq(gdb);
+        expect(
+            await resolveExecutable('nogdb', undefined, { PATH: dir })
+        ).to.eq(undefined);
+    });
+
+    it('keeps probes across instances', async () => {
+        const cache = new GdbProbeCache(file);
+        expect(await cache.lookup(gdb)).to.eq(undefined);
+        await cache.store(gdb, undefined, undefined, { version: '12.1' });
+        await cache.store(gdb, undefined, undefined, {
+            features: ['python'],
+            python: true,
+        });
+
+        const other = new GdbProbeCache(file);
+        const probe = await other.lookup(gdb);
+        expect(probe?.version).to.eq('12.1');
+        expect(probe?.features).to.deep.eq(['python']);
+        expect(probe?.python).to.eq(true);
+    });
+
+    it('forgets probes of a changed gdb', async () => {
+        const cache = new GdbProbeCache(file);
+        await cache.store(gdb, undefined, undefined, { version: '12.1' });
+        fs.writeFileSync(gdb, 'gdb 13.2.1');
+        expect(await cache.lookup(gdb)).to.eq(undefined);
+    });
+
+    it('ignores a corrupt cache', async () => {
+        fs.mkdirSync(path.dirname(file));
+        fs.writeFileSync(file, '{"version":');
+        const cache = new GdbProbeCache(file);
+        expect(await cache.lookup(gdb)).to.eq(undefined);
+        await cache.store(gdb, undefined, undefined, { version: '12.1' });
+        expect((await cache.lookup(gdb))?.version).to.eq('12.1');
+    });
+
+    it('fails silently when the cache cannot be written', async () => {
+        // under a file, the directory cannot be created
+        const under = new GdbProbeCache(path.join(gdb, 'gdb-probes.json'));
+        await under.store(gdb, undefined, undefined, { version: '12.1' });
+        // a directory in the way, the file cannot be replaced
+        fs.mkdirSync(file, { recursive: true });
+        const blocked = new GdbProbeCache(file);
+        await blocked.store(gdb, undefined, undefined, { version: '12.1' });
+        expect(fs.readdirSync(path.dirname(file))).to.deep.eq([
+            path.basename(file),
+        ]);
+    });
+
+    it('can be turned off', () => {
+        const saved = process.env[NO_PROBE_CACHE_VARIABLE];
+        try {
+            delete process.env[NO_PROBE_CACHE_VARIABLE];
+            expect(probeCache()).to.eq(gdbProbeCache);
+            expect(probeCache(false)).to.eq(undefined);
+            process.env[NO_PROBE_CACHE_VARIABLE] = '1';
+            expect(probeCache(true)).to.eq(undefined);
+        } finally {
+            if (saved === undefined) {
+                delete process.env[NO_PROBE_CACHE_VARIABLE];
+            } else {
+                process.env[NO_PROBE_CACHE_VARIABLE] = saved;
+            }
+        }
+    });
+});
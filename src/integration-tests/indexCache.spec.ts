@@ -0,0 +1,116 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import {
+    indexCacheCommand,
+    readSymbolIndexInfo,
+    SymbolLoadHistory,
+} from '../indexCache';
+
+/** A 64-bit little-endian ELF file that only has sections */
+function elf64(sections: Array<{ name: string; data: Buffer }>) {
+    const names = Buffer.from(
+        ['', '.shstrtab', ...sections.map(({ name }) => name)].join('\0') +
+            '\0'
+    );
+    const all = [{ name: '.shstrtab', data: names }, ...sections];
+    let offset = 64;
+    const headers: Buffer[] = [Buffer.alloc(64)];
+    let nameOffset = 1;
+    for (const { name, data } of all) {
+        const header = Buffer.alloc(64);
+        header.writeUInt32LE(nameOffset, 0);
+        header.writeUInt32LE(offset, 0x18);
+        header.writeUInt32LE(data.length, 0x20);
+        headers.push(header);
+        nameOffset += name.length + 1;
+        offset += data.length;
+    }
+    const header = Buffer.alloc(64);
+    header.writeUInt32BE(0x7f454c46, 0);
+    header[4] = 2;
+    header[5] = 1;
+    header.writeUInt32LE(offset, 0x28);
+    header.writeUInt16LE(64, 0x3a);
+    header.writeUInt16LE(headers.length, 0x3c);
+    header.writeUInt16LE(1, 0x3e);
+    return Buffer.concat([header, ...all.map(({ data }) => data), ...headers]);
+}
+
+function buildIdNote(id: string) {
+    const note = Buffer.alloc(16 + id.length / 2);
+    note.writeUInt32LE(4, 0);
+    note.writeUInt32LE(id.length / 2, 4);
+    note.writeUInt32LE(3, 8);
+    note.write('GNU\0', 12, 'latin1');
+    note.write(id, 16, 'hex');
+    return note;
+}
+
+describe('index cache', () => {
+    let dir: string;
+
+    beforeEach(() => {
+        dir = fs.mkdtempSync(path.join(os.tmpdir(), 'index-cache-'));
+    });
+
+    afterEach(() => {
+        fs.rmSync(dir, { recursive: true, force: true });
+    });
+
+    it('reads the build id and the index of ELF files', async () => {
+        const program = path.join(dir, 'program');
+        fs.writeFileSync(
+            program,
+            elf64([
+                { name: '.note.gnu.build-id', data: buildIdNote('c0ffee42') },
+                { name: '.text', data: Buffer.alloc(16) },
+            ])
+        );
+        expect(await readSymbolIndexInfo(program)).to.deep.eq({
+            hasIndex: false,
+            buildId: 'c0ffee42',
+        });
+
+        fs.writeFileSync(
+            program,
+            elf64([{ name: '.gdb_index', data: Buffer.alloc(8) }])
+        );
+        expect(await readSymbolIndexInfo(program)).to.deep.eq({
+            hasIndex: true,
+        });
+    });
+
+    it('ignores other files', async () => {
+        const script = path.join(dir, 'script');
+        fs.writeFileSync(script, '#!/bin/sh\n');
+        expect(await readSymbolIndexInfo(script)).to.eq(undefined);
+    });
+
+    it('enables the index cache the way gdb expects', () => {
+        expect(indexCacheCommand('8.3')).to.eq('set index-cache on');
+        expect(indexCacheCommand('12.1')).to.eq('set index-cache enabled on');
+    });
+
+    it('keeps the last cold and warm load times', async () => {
+        const history = new SymbolLoadHistory(path.join(dir, 'loads.json'));
+        await history.record('/work/program', false, 20000);
+        expect(await history.record('/work/program', true, 800)).to.deep.eq({
+            cold: 20000,
+            warm: 800,
+        });
+        expect(await history.read()).to.deep.eq({
+            '/work/program': { cold: 20000, warm: 800 },
+        });
+    });
+});
@@ -14,6 +14,7 @@ import * as os from 'os';
 import { LaunchRequestArguments } from '../GDBDebugSession';
 import { CdtDebugClient } from './debugClient';
 import {
+    debugServerPort,
     fillDefaults,
     gdbNonStop,
     isRemoteTest,
@@ -51,6 +52,37 @@ describe('launch', function () {
         );
     });
 
+    it('reports the progress of loading symbols', async function () {
+        // the standard client does not support progress reporting
+        await dc.stop();
+        dc = new CdtDebugClient();
+        await dc.start(debugServerPort);
+        await dc.initializeRequest({
+            adapterID: 'gdb',
+            linesStartAt1: true,
+            columnsStartAt1: true,
+            pathFormat: 'path',
+            supportsProgressReporting: true,
+        });
+        const progressStart = dc.waitForEvent('progressStart');
+        const progressEnd = dc.waitForEvent('progressEnd');
+        await dc.hitBreakpoint(
+            fillDefaults(this.test, {
+                program: emptyProgram,
+            } as LaunchRequestArguments),
+            {
+                path: emptySrc,
+                line: 3,
+            }
+        );
+        const start = await progressStart;
+        expect(start.body.title).to.eq('Loading symbols');
+        expect(start.body.message).to.eq(path.basename(emptyProgram));
+        expect((await progressEnd).body.progressId).to.eq(
+            start.body.progressId
+        );
+    });
+
     it('reports an error when specifying a non-existent binary', async function () {
         const errorMessage = await new Promise<Error>((resolve, reject) => {
             dc.launchRequest(
@@ -224,6 +224,7 @@ describe('Memory Test Suite', function () {
         const normalize = (original: string): string => original.toLowerCase();
 
         const hexToBase64TestCases = [
+            '',
             'fe',
             '00',
             'fedc',
@@ -232,6 +233,7 @@ describe('Memory Test Suite', function () {
         ];
 
         const base64ToHexTestCases = [
+            '',
             'bGlnaHQgd29yay4=',
             'bGlnaHQgd29yaw==',
             'abc',
@@ -258,6 +260,7 @@ describe('Memory Test Suite', function () {
             'ab',
             'a',
             'a=',
+            '==',
             'abcde',
             '!A==',
             '#$*@^',
@@ -271,5 +274,13 @@ describe('Memory Test Suite', function () {
         for (const test of base64ToHexTestCases) {
             expect(() => base64ToHex(test)).throws();
         }
+
+        // large inputs are cut short in the message
+        expect(() => base64ToHex('!'.repeat(100000))).throws(
+            /^Received ill-formed base64 input: !{32}\.\.\. \(100000 characters\)$/
+        );
+        expect(() => hexToBase64('z'.repeat(100000))).throws(
+            /^Received ill-formed hex input: z{32}\.\.\. \(100000 characters\)$/
+        );
     });
 });
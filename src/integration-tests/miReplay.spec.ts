@@ -0,0 +1,153 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { LaunchRequestArguments } from '../GDBDebugSession';
+import { MIReplayBackend } from '../miReplayBackend';
+import {
+    MIRecorder,
+    MIRecording,
+    MITraceDirection,
+    readMIRecording,
+} from '../miTrace';
+
+describe('MI record and replay', () => {
+    let file: string;
+
+    beforeEach(() => {
+        file = path.join(
+            fs.mkdtempSync(path.join(os.tmpdir(), 'mirec-')),
+            'session.mirec'
+        );
+    });
+
+    afterEach(() => {
+        fs.rmSync(path.dirname(file), { recursive: true, force: true });
+    });
+
+    function record(traffic: Array<[MITraceDirection, number, string]>) {
+        const recorder = new MIRecorder(file, { gdbVersion: '12.1' });
+        for (const [direction, token, data] of traffic) {
+            recorder.record(direction, token, Buffer.from(data));
+        }
+        recorder.close();
+        return readMIRecording(file);
+    }
+
+    async function start(recording: MIRecording) {
+        const backend = new MIReplayBackend(recording);
+        await backend.spawn({ program: '' } as LaunchRequestArguments);
+        return backend;
+    }
+
+    const startup: Array<[MITraceDirection, number, string]> = [
+        [MITraceDirection.In, -1, '=thread-group-added,id="i1"'],
+        [MITraceDirection.In, -1, '(gdb) '],
+        [MITraceDirection.Out, 0, '-gdb-set non-stop off'],
+        [MITraceDirection.In, 0, '0^done'],
+        [MITraceDirection.Out, 1, '-gdb-set mi-async on'],
+        [MITraceDirection.In, 1, '1^done'],
+    ];
+
+    it('reads back what was recorded', () => {
+        const recording = record(startup);
+        expect(recording.metadata).to.deep.eq({ gdbVersion: '12.1' });
+        expect(
+            recording.entries.map((entry) => [
+                entry.direction,
+                entry.token,
+                entry.data.toString(),
+            ])
+        ).to.deep.eq(startup);
+    });
+
+    it('ignores an interrupted last entry', () => {
+        record(startup);
+        fs.truncateSync(file, fs.statSync(file).size - 2);
+        expect(readMIRecording(file).entries).to.have.length(5);
+    });
+
+    it('rejects other files', () => {
+        fs.writeFileSync(file, 'not a recording');
+        expect(() => readMIRecording(file)).to.throw(/not an MI recording/);
+    });
+
+    it('replays the recorded replies with new tokens', async () => {
+        const backend = await start(
+            record([
+                ...startup,
+                [MITraceDirection.Out, 7, '-stack-info-depth'],
+                [MITraceDirection.In, 7, '7^done,depth="3"'],
+                [MITraceDirection.Out, 8, '-stack-info-depth'],
+                [MITraceDirection.In, 8, '8^done,depth="4"'],
+            ])
+        );
+        const depths: string[] = [];
+        for (let i = 0; i < 3; i++) {
+            const result = await backend.sendCommand<{ depth: string }>(
+                '-stack-info-depth'
+            );
+            depths.push(result.depth);
+        }
+        expect(depths).to.deep.eq(['3', '4', '3']);
+        expect(backend.misses).to.deep.eq([]);
+    });
+
+    it('sends the asynchronous records that followed a command', async () => {
+        const backend = await start(
+            record([
+                ...startup,
+                [MITraceDirection.Out, 2, '-exec-continue'],
+                [MITraceDirection.In, 2, '2^running'],
+                [MITraceDirection.In, -1, '*running,thread-id="all"'],
+            ])
+        );
+        const running = new Promise((resolve) =>
+            backend.on('execAsync', (asyncClass) => resolve(asyncClass))
+        );
+        await backend.sendCommand('-exec-continue');
+        expect(await running).to.eq('running');
+    });
+
+    it('matches results of overlapping commands by token', async () => {
+        const backend = await start(
+            record([
+                ...startup,
+                [MITraceDirection.Out, 2, '-data-evaluate-expression a'],
+                [MITraceDirection.Out, 3, '-data-evaluate-expression b'],
+                [MITraceDirection.In, 2, '2^done,value="1"'],
+                [MITraceDirection.In, 3, '3^done,value="2"'],
+            ])
+        );
+        const [a, b] = await Promise.all([
+            backend.sendCommand<{ value: string }>(
+                '-data-evaluate-expression a'
+            ),
+            backend.sendCommand<{ value: string }>(
+                '-data-evaluate-expression b'
+            ),
+        ]);
+        expect([a.value, b.value]).to.deep.eq(['1', '2']);
+    });
+
+    it('fails commands that were not recorded', async () => {
+        const backend = await start(record(startup));
+        let error: Error | undefined;
+        try {
+            await backend.sendCommand('-thread-info');
+        } catch (err) {
+            error = err as Error;
+        }
+        expect(error?.message).to.eq('No recorded reply for -thread-info');
+        expect(backend.misses).to.deep.eq(['-thread-info']);
+    });
+});
@@ -0,0 +1,78 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import { MITrace, MITraceDirection } from '../miTrace';
+
+describe('MITrace', () => {
+    let tracer: MITrace;
+
+    beforeEach(() => {
+        tracer = new MITrace();
+    });
+
+    it('is disabled by default', () => {
+        expect(tracer.enabled).to.eq(false);
+        tracer.traceOut(1, '-gdb-version');
+        expect(tracer.read()).to.deep.eq([]);
+    });
+
+    it('records traffic in both directions', () => {
+        tracer.setBufferSize(1024);
+        expect(tracer.enabled).to.eq(true);
+        tracer.traceOut(12, '-break-list');
+        tracer.traceIn(Buffer.from('12^done,BreakpointTable={}'));
+        tracer.traceIn('=thread-group-added,id="i1"');
+
+        const entries = tracer.read();
+        expect(
+            entries.map((entry) => [entry.direction, entry.token, entry.data])
+        ).to.deep.eq([
+            [MITraceDirection.Out, 12, '-break-list'],
+            [MITraceDirection.In, 12, '12^done,BreakpointTable={}'],
+            [MITraceDirection.In, -1, '=thread-group-added,id="i1"'],
+        ]);
+        expect(entries[0].time).to.be.closeTo(Date.now(), 1000);
+
+        const dump = tracer.dump();
+        expect(dump[0]).to.match(/ -> 12-break-list$/);
+        expect(dump[1]).to.match(/ <- 12\^done,BreakpointTable=\{\}$/);
+    });
+
+    it('records lines that start with long numbers without a token', () => {
+        tracer.setBufferSize(1024);
+        tracer.traceIn('123456789^done');
+        tracer.traceIn('12345678901234567890 printed by the program');
+        expect(tracer.read().map((entry) => entry.token)).to.deep.eq([
+            123456789, -1,
+        ]);
+    });
+
+    it('keeps the most recent entries when full', () => {
+        // 17 bytes of header and 8 of data per entry
+        tracer.setBufferSize(60);
+        for (let i = 0; i < 10; i++) {
+            tracer.traceOut(i, `-cmd-00${i}`);
+        }
+        const entries = tracer.read();
+        expect(entries.map((entry) => entry.token)).to.deep.eq([8, 9]);
+        expect(entries.map((entry) => entry.data)).to.deep.eq([
+            '-cmd-008',
+            '-cmd-009',
+        ]);
+    });
+
+    it('truncates entries larger than the buffer', () => {
+        tracer.setBufferSize(27);
+        tracer.traceIn('^done,value="0123456789"');
+        expect(tracer.read().map((entry) => entry.data)).to.deep.eq([
+            '^done,valu',
+        ]);
+    });
+});
@@ -12,165 +12,403 @@ import { GDBBackend } from '../GDBBackend';
 import { MIParser } from '../MIParser';
 import * as sinon from 'sinon';
 import { logger } from '@vscode/debugadapter/lib/logger';
+import { expect } from 'chai';
+import { PassThrough } from 'stream';
+import { loadNativeMIParser } from '../native/mi-parser';
 
-describe('MI Parser Test Suite', function () {
-    let gdbBackendMock: sinon.SinonStubbedInstance<GDBBackend>;
-    let loggerErrorSpy: sinon.SinonSpy;
-    let parser: MIParser;
+class TypeScriptMIParser extends MIParser {
+    protected nativeParser = undefined;
+}
 
-    beforeEach(async function () {
-        gdbBackendMock = sinon.createStubInstance(GDBBackend);
-        loggerErrorSpy = sinon.spy(logger, 'error');
+/** The suite runs with each parser, against the same expectations */
+const parsers: Array<[string, typeof MIParser]> = [
+    ['TypeScript', TypeScriptMIParser],
+    ['native', MIParser],
+];
 
-        parser = new MIParser(gdbBackendMock);
-    });
+for (const [name, Parser] of parsers) {
+    describe(`MI Parser Test Suite (${name})`, function () {
+        let gdbBackendMock: sinon.SinonStubbedInstance<GDBBackend>;
+        let loggerErrorSpy: sinon.SinonSpy;
+        let parser: MIParser;
 
-    afterEach(function () {
-        try {
-            sinon.assert.notCalled(loggerErrorSpy);
-        } finally {
-            sinon.restore();
-        }
-    });
+        before(function () {
+            if (Parser === MIParser && !loadNativeMIParser()) {
+                // The native parser is only built on some platforms
+                this.skip();
+            }
+        });
 
-    it('simple result-record', async function () {
-        const callback = sinon.spy();
-        parser.queueCommand(5, callback);
-        parser.parseLine('5^done');
-        sinon.assert.calledOnceWithExactly(callback, 'done', {});
-    });
+        beforeEach(async function () {
+            gdbBackendMock = sinon.createStubInstance(GDBBackend);
+            loggerErrorSpy = sinon.spy(logger, 'error');
 
-    it('simple result-record with multi-digit token', async function () {
-        const callback = sinon.spy();
-        parser.queueCommand(1234, callback);
-        parser.parseLine('1234^done');
-        sinon.assert.calledOnceWithExactly(callback, 'done', {});
-    });
+            parser = new Parser(gdbBackendMock);
+        });
 
-    it('simple result-record for unknown token number', async function () {
-        parser.parseLine('5^done');
-        sinon.assert.calledOnceWithExactly(
-            loggerErrorSpy,
-            'GDB response with no command: 5'
-        );
-        loggerErrorSpy.resetHistory();
-    });
+        afterEach(function () {
+            try {
+                sinon.assert.notCalled(loggerErrorSpy);
+            } finally {
+                sinon.restore();
+            }
+        });
 
-    it('simple result-record for no token number', async function () {
-        parser.parseLine('^done');
-        sinon.assert.calledOnceWithExactly(
-            loggerErrorSpy,
-            'GDB response with no command: '
-        );
-        loggerErrorSpy.resetHistory();
-    });
+        it('simple result-record', async function () {
+            const callback = sinon.spy();
+            parser.queueCommand(5, callback);
+            parser.parseLine('5^done');
+            sinon.assert.calledOnceWithExactly(callback, 'done', {});
+        });
 
-    it('simple console-stream-output', async function () {
-        parser.parseLine('~"message"');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'consoleStreamOutput',
-            'message',
-            'stdout'
-        );
-    });
+        it('simple result-record with multi-digit token', async function () {
+            const callback = sinon.spy();
+            parser.queueCommand(1234, callback);
+            parser.parseLine('1234^done');
+            sinon.assert.calledOnceWithExactly(callback, 'done', {});
+        });
 
-    it('simple target-stream-output', async function () {
-        parser.parseLine('@"message"');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'consoleStreamOutput',
-            'message',
-            'stdout'
-        );
-    });
+        it('simple result-record for unknown token number', async function () {
+            parser.parseLine('5^done');
+            sinon.assert.calledOnceWithExactly(
+                loggerErrorSpy,
+                'GDB response with no command: 5'
+            );
+            loggerErrorSpy.resetHistory();
+        });
 
-    it('simple log-stream-output', async function () {
-        parser.parseLine('&"message"');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'consoleStreamOutput',
-            'message',
-            'log'
-        );
-    });
+        it('simple result-record for no token number', async function () {
+            parser.parseLine('^done');
+            sinon.assert.calledOnceWithExactly(
+                loggerErrorSpy,
+                'GDB response with no command: '
+            );
+            loggerErrorSpy.resetHistory();
+        });
+
+        it('simple console-stream-output', async function () {
+            parser.parseLine('~"message"');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'consoleStreamOutput',
+                'message',
+                'stdout'
+            );
+        });
+
+        it('console-stream-output with escapes', async function () {
+            parser.parseLine(
+                '~"bug275-\\346\\265\\213\\350\\257\\225.c \\"\\1a2\\"\\t\\r\\n"'
+            );
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'consoleStreamOutput',
+                'bug275-\u6d4b\u8bd5.c "\u0001"\t\n',
+                'stdout'
+            );
+        });
+
+        it('simple target-stream-output', async function () {
+            parser.parseLine('@"message"');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'consoleStreamOutput',
+                'message',
+                'stdout'
+            );
+        });
+
+        it('simple log-stream-output', async function () {
+            parser.parseLine('&"message"');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'consoleStreamOutput',
+                'message',
+                'log'
+            );
+        });
+
+        it('simple notify-async-output', async function () {
+            parser.parseLine('=message,object={value="1234"}');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'notifyAsync',
+                'message',
+                {
+                    object: {
+                        value: '1234',
+                    },
+                }
+            );
+        });
 
-    it('simple notify-async-output', async function () {
-        parser.parseLine('=message,object={value="1234"}');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'notifyAsync',
-            'message',
-            {
-                object: {
-                    value: '1234',
-                },
+        it('simple exec-async-output', async function () {
+            parser.parseLine('*message,object={value="1234"}');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'execAsync',
+                'message',
+                {
+                    object: {
+                        value: '1234',
+                    },
+                }
+            );
+        });
+
+        it('simple status-async-output', async function () {
+            parser.parseLine('+message,object={value="1234"}');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'statusAsync',
+                'message',
+                {
+                    object: {
+                        value: '1234',
+                    },
+                }
+            );
+        });
+
+        it('simple non-MI output', async function () {
+            // this is when the output line doesn't match any of
+            // expected output syntax so we just log it back to the
+            // user. This can happen when the inferior's stdout
+            // is the same as gdb's stdout.
+            parser.parseLine('other');
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'consoleStreamOutput',
+                // XXX: This tests for how this code has always been
+                // implemented, but it isn't particularly useful to do this.
+                // Fixing it is low priority because users should avoid having
+                // inferior stdout being on the MI stdout as it leads to
+                // parsing errors
+                'other\n',
+                'stdout'
+            );
+        });
+
+        it('structure that starts with a curly bracket and contains values but not keys', async function () {
+            parser.parseLine(
+                '+message,bkpt={number="1",type="breakpoint",thread-groups=["i1"],script={"p }123","p 321","p 789"}}'
+            );
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'statusAsync',
+                'message',
+                {
+                    bkpt: {
+                        number: '1',
+                        type: 'breakpoint',
+                        'thread-groups': ['i1'],
+                        script: { '0': 'p }123', '1': 'p 321', '2': 'p 789' },
+                    },
+                }
+            );
+        });
+
+        it('lines split across chunks', async function () {
+            const stream = new PassThrough();
+            parser.parse(stream);
+            const callback = sinon.spy();
+            parser.queueCommand(5, callback);
+            // split in the middle of a multi-byte character and between \r
+            // and \n
+            const data = Buffer.from('\u00e9t\u00e9\r\n5^done,value="1"\r\n');
+            for (const chunk of [
+                data.subarray(0, 1),
+                data.subarray(1, 6),
+                data.subarray(6, 8),
+                data.subarray(8),
+            ]) {
+                stream.write(chunk);
             }
-        );
+            await new Promise((resolve) => setImmediate(resolve));
+            sinon.assert.calledOnceWithExactly(
+                gdbBackendMock.emit as sinon.SinonStub,
+                'consoleStreamOutput',
+                '\u00e9t\u00e9\n',
+                'stdout'
+            );
+            sinon.assert.calledOnceWithExactly(callback, 'done', {
+                value: '1',
+            });
+        });
+
+        it('lazy result-record', async function () {
+            const line =
+                '5^done,threads=[{id="1",frame={func="main",args=[{name="argc",value="1"}]},state="stopped"}],current-thread-id="1",value="\\"{["';
+            const eager = sinon.spy();
+            parser.queueCommand(5, eager);
+            parser.parseLine(line);
+            const lazy = sinon.spy();
+            parser.queueCommand(5, lazy, { lazy: true });
+            parser.parseLine(line);
+            const result = lazy.firstCall.args[1];
+            // not decoded until it is accessed
+            const threads = Object.getOwnPropertyDescriptor(result, 'threads');
+            expect(typeof threads?.get).to.equal('function');
+            expect(result.threads[0].frame.args[0].name).to.equal('argc');
+            expect(JSON.parse(JSON.stringify(result))).to.deep.equal(
+                eager.firstCall.args[1]
+            );
+        });
+
+        it('result-record with field selector', async function () {
+            const callback = sinon.spy();
+            parser.queueCommand(5, callback, { fields: ['depth'] });
+            parser.parseLine('5^done,frame={level="0",args=[]},depth="3"');
+            sinon.assert.calledOnceWithExactly(callback, 'done', {
+                depth: '3',
+            });
+        });
+
+        it('error result-record with field selector', async function () {
+            const callback = sinon.spy();
+            parser.queueCommand(5, callback, { fields: ['depth'], lazy: true });
+            parser.parseLine('5^error,msg="No registers."');
+            sinon.assert.calledOnceWithExactly(callback, 'error', {
+                msg: 'No registers.',
+            });
+        });
+
+        it('memory result-record decoded to Buffer', async function () {
+            const callback = sinon.spy();
+            parser.queueCommand(5, callback, { hexContents: true });
+            parser.parseLine(
+                Buffer.from(
+                    '5^done,memory=[{begin="0x10",offset="0x0",end="0x12",contents="dEad"},{begin="0x20",offset="0x0",end="0x21",contents="01"}]'
+                )
+            );
+            sinon.assert.calledOnceWithExactly(callback, 'done', {
+                memory: [
+                    {
+                        begin: '0x10',
+                        offset: '0x0',
+                        end: '0x12',
+                        contents: '',
+                        data: Buffer.from([0xde, 0xad]),
+                    },
+                    {
+                        begin: '0x20',
+                        offset: '0x0',
+                        end: '0x21',
+                        contents: '',
+                        data: Buffer.from([0x01]),
+                    },
+                ],
+            });
+        });
+
+        it('memory result-record with ill-formed hex', async function () {
+            const callback = sinon.spy();
+            parser.queueCommand(5, callback, { hexContents: true });
+            parser.parseLine(
+                '5^done,memory=[{begin="0x10",offset="0x0",end="0x12",contents="0fx"}]'
+            );
+            sinon.assert.calledOnceWithExactly(callback, 'done', {
+                memory: [
+                    {
+                        begin: '0x10',
+                        offset: '0x0',
+                        end: '0x12',
+                        contents: '0fx',
+                    },
+                ],
+            });
+        });
     });
+}
 
-    it('simple exec-async-output', async function () {
-        parser.parseLine('*message,object={value="1234"}');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'execAsync',
-            'message',
-            {
-                object: {
-                    value: '1234',
-                },
-            }
-        );
+describe('MI Parser native/TypeScript differential', function () {
+    // lines beyond the cases of the suite above, compared between parsers
+    const corpus = [
+        '5^done',
+        '^done',
+        '12^error,msg="No symbol \\"foo\\" in current context."',
+        '3^done,bkpt={number="1",addr="<MULTIPLE>"},{number="1.1",func="staticfunc1",file="functions.c"},{number="1.2",func="staticfunc1",file="functions_other.c"}',
+        '7^done,stack=[frame={level="0",addr="0x0000555555555131",func="main",file="empty.c",fullname="/tmp/empty.c",line="3",arch="i386:x86-64"}]',
+        '8^done,variables=[{name="a",value="1"},{name="b",value="0x0"}]',
+        '9^done,memory=[{begin="0x7ffe",offset="0x0",end="0x7ffe0008",contents="0102030405060708"}]',
+        '10^done,features=["frozen-varobjs","pending-breakpoints","thread-info","data-read-memory-bytes","python"]',
+        '11^done,value="\\"hello\\\\n\\"",empty="",tab="\\t",cr="a\\rb"',
+        '+message,bkpt={number="1",type="breakpoint",thread-groups=["i1"],script={"p }123","p 321","p 789"}}',
+        '*stopped,reason="breakpoint-hit",disp="keep",bkptno="1",frame={addr="0x1",func="main",args=[],file="a.c",line="4"},thread-id="1",stopped-threads="all",core="2"',
+        '*running,thread-id="all"',
+        '=thread-group-added,id="i1"',
+        '=library-loaded,id="/lib64/ld-linux-x86-64.so.2",ranges=[{from="0x1",to="0x2"}]',
+        '~"GNU gdb (GDB) 12.1\\n"',
+        '~"\\303\\251t\\303\\251\\n"',
+        '~"\\377invalid utf-8"',
+        '~"\\1a2 short octal"',
+        '@"target output\\n"',
+        '&"warning: log stream\\n"',
+        '~""',
+        '&',
+        '(gdb) ',
+        'other',
+        '',
+    ];
+
+    let gdbBackendMock: sinon.SinonStubbedInstance<GDBBackend>;
+    let nativeParser: MIParser;
+    let typeScriptParser: MIParser;
+
+    before(function () {
+        if (!loadNativeMIParser()) {
+            // The native parser is only built on some platforms
+            this.skip();
+        }
     });
 
-    it('simple status-async-output', async function () {
-        parser.parseLine('+message,object={value="1234"}');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'statusAsync',
-            'message',
-            {
-                object: {
-                    value: '1234',
-                },
-            }
-        );
+    beforeEach(function () {
+        gdbBackendMock = sinon.createStubInstance(GDBBackend);
+        sinon.stub(logger, 'error');
+        nativeParser = new MIParser(gdbBackendMock);
+        typeScriptParser = new TypeScriptMIParser(gdbBackendMock);
     });
 
-    it('simple non-MI output', async function () {
-        // this is when the output line doesn't match any of
-        // expected output syntax so we just log it back to the
-        // user. This can happen when the inferior's stdout
-        // is the same as gdb's stdout.
-        parser.parseLine('other');
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'consoleStreamOutput',
-            // XXX: This tests for how this code has always been implemented,
-            // but it isn't particularly useful to do this. Fixing it is low
-            // priority because users should avoid having inferior stdout
-            // being on the MI stdout as it leads to parsing errors
-            'other\n',
-            'stdout'
-        );
+    afterEach(function () {
+        sinon.restore();
     });
 
-    it('structure that starts with a curly bracket and contains values but not keys', async function () {
-        parser.parseLine(
-            '+message,bkpt={number="1",type="breakpoint",thread-groups=["i1"],script={"p }123","p 321","p 789"}}'
-        );
-        sinon.assert.calledOnceWithExactly(
-            gdbBackendMock.emit as sinon.SinonStub,
-            'statusAsync',
-            'message',
-            {
-                bkpt: {
-                    number: '1',
-                    type: 'breakpoint',
-                    'thread-groups': ['i1'],
-                    script: { '0': 'p }123', '1': 'p 321', '2': 'p 789' },
-                },
-            }
-        );
+    function parseWith(parser: MIParser, line: string) {
+        const emit = gdbBackendMock.emit as sinon.SinonStub;
+        emit.resetHistory();
+        const callback = sinon.spy();
+        parser.queueCommand(Number.parseInt(line, 10), callback);
+        parser.parseLine(line);
+        return {
+            emitted: emit.getCalls().map((call) => call.args),
+            results: callback.getCalls().map((call) => call.args),
+        };
+    }
+
+    for (const line of corpus) {
+        it(`parses ${JSON.stringify(line)} identically`, function () {
+            expect(parseWith(nativeParser, line)).to.deep.equal(
+                parseWith(typeScriptParser, line)
+            );
+        });
+    }
+
+    it('decodes hex contents identically', function () {
+        const bytes = Buffer.from(Array.from({ length: 300 }, (_, i) => i));
+        const hex = bytes.toString('hex');
+        const decode = (parser: MIParser, contents: string) => {
+            const callback = sinon.spy();
+            parser.queueCommand(9, callback, { hexContents: true });
+            parser.parseLine(
+                '9^done,memory=[{begin="0x1000",offset="0x0",' +
+                    `end="0x112c",contents="${contents}"}]`
+            );
+            return callback.getCalls().map((call) => call.args);
+        };
+        for (const contents of [hex, hex.toUpperCase(), hex + 'g0']) {
+            expect(decode(nativeParser, contents)).to.deep.equal(
+                decode(typeScriptParser, contents)
+            );
+        }
     });
 });
@@ -0,0 +1,61 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import { OutputAggregator } from '../outputAggregator';
+
+describe('OutputAggregator', () => {
+    let sent: Array<[string, string]>;
+    let aggregator: OutputAggregator;
+
+    beforeEach(() => {
+        sent = [];
+        aggregator = new OutputAggregator(
+            (output, category) => sent.push([output, category]),
+            10
+        );
+    });
+
+    it('merges output of the same category', async () => {
+        aggregator.append('a\n', 'stdout');
+        aggregator.append('b\n', 'stdout');
+        expect(sent).to.deep.eq([]);
+        await new Promise((resolve) => setImmediate(resolve));
+        expect(sent).to.deep.eq([['a\nb\n', 'stdout']]);
+    });
+
+    it('keeps the order of categories', () => {
+        aggregator.append('a\n', 'stdout');
+        aggregator.append('b\n', 'log');
+        aggregator.append('c\n', 'stdout');
+        aggregator.flush();
+        expect(sent).to.deep.eq([
+            ['a\n', 'stdout'],
+            ['b\n', 'log'],
+            ['c\n', 'stdout'],
+        ]);
+    });
+
+    it('sends output over the threshold', () => {
+        aggregator.append('0123\n', 'stdout');
+        aggregator.append('56789\n', 'stdout');
+        aggregator.append('a\n', 'stdout');
+        expect(sent).to.deep.eq([['0123\n56789\n', 'stdout']]);
+    });
+
+    it('sends each output with a threshold of 0', () => {
+        aggregator.threshold = 0;
+        aggregator.append('a\n', 'stdout');
+        aggregator.append('b\n', 'stdout');
+        expect(sent).to.deep.eq([
+            ['a\n', 'stdout'],
+            ['b\n', 'stdout'],
+        ]);
+    });
+});
@@ -0,0 +1,127 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import { LaunchRequestArguments } from '../GDBDebugSession';
+import { MIReplayBackend } from '../miReplayBackend';
+import { MITraceDirection } from '../miTrace';
+
+class TestBackend extends MIReplayBackend {
+    public writes: string[] = [];
+
+    public setFeatures(features: string[]) {
+        this.gdbFeatures = features;
+    }
+
+    protected replay(data: string) {
+        this.writes.push(data);
+        super.replay(data);
+    }
+}
+
+describe('GDBBackend pipelining', () => {
+    let backend: TestBackend;
+
+    beforeEach(async () => {
+        const traffic: Array<[MITraceDirection, number, string]> = [
+            [MITraceDirection.In, -1, '(gdb) '],
+            [MITraceDirection.Out, 0, '-gdb-set non-stop off'],
+            [MITraceDirection.In, 0, '0^done'],
+            [MITraceDirection.Out, 1, '-gdb-set mi-async on'],
+            [MITraceDirection.In, 1, '1^done'],
+            [MITraceDirection.Out, 2, 'set print pretty on'],
+            [MITraceDirection.In, 2, '2^done'],
+            [MITraceDirection.Out, 3, 'set sysroot /nowhere'],
+            [MITraceDirection.In, 3, '3^error,msg="No such file"'],
+            [MITraceDirection.Out, 4, '-gdb-show version'],
+            [MITraceDirection.In, 4, '4^done,value="12.1"'],
+            [MITraceDirection.Out, 5, '-exec-arguments a b'],
+            [MITraceDirection.In, 5, '5^done'],
+        ];
+        backend = new TestBackend({
+            metadata: { gdbVersion: '12.1' },
+            entries: traffic.map(([direction, token, data]) => ({
+                time: 0,
+                direction,
+                token,
+                data: Buffer.from(data),
+            })),
+        });
+        await backend.spawn({ program: '' } as LaunchRequestArguments);
+        backend.writes = [];
+    });
+
+    it('writes the commands at once', async () => {
+        const results = await backend.sendPipelined([
+            'set print pretty on',
+            'set sysroot /nowhere',
+            '-gdb-show version',
+        ]);
+        expect(backend.writes).to.deep.eq([
+            '2set print pretty on\n3set sysroot /nowhere\n4-gdb-show version\n',
+        ]);
+        expect(results.length).to.eq(3);
+        expect(results[0]).to.deep.eq({ result: {} });
+        expect(results[1].error?.message).to.eq('No such file');
+        expect(results[2]).to.deep.eq({ result: { value: '12.1' } });
+    });
+
+    it('stops sendCommands at the first error', async () => {
+        let error: Error | undefined;
+        try {
+            await backend.sendCommands([
+                'set print pretty on',
+                'set sysroot /nowhere',
+                '-gdb-show version',
+            ]);
+        } catch (err) {
+            error = err as Error;
+        }
+        expect(error?.message).to.eq('No such file');
+        expect(backend.writes).to.deep.eq([
+            '2set print pretty on\n',
+            '3set sysroot /nowhere\n',
+        ]);
+    });
+
+    it('writes a pipeline of mixed priorities in order', async () => {
+        const results = await backend.sendPipelined([
+            'set print pretty on',
+            '-exec-arguments a b',
+            '-gdb-show version',
+        ]);
+        expect(backend.writes).to.deep.eq([
+            '2set print pretty on\n3-exec-arguments a b\n4-gdb-show version\n',
+        ]);
+        expect(results.map(({ error }) => error)).to.deep.eq([
+            undefined,
+            undefined,
+            undefined,
+        ]);
+    });
+
+    it('skips pretty printing when gdb has no Python', async () => {
+        backend.setFeatures(['thread-info', 'data-read-memory-bytes']);
+        await backend.sendEnablePrettyPrint();
+        expect(backend.writes).to.deep.eq([]);
+        expect(backend.hasPython()).to.eq(false);
+    });
+
+    it('pipelines the commands of helpers', async () => {
+        const [pretty, version] = await backend.pipeline(() =>
+            Promise.all([
+                backend.sendCommand('set print pretty on'),
+                backend.sendGDBShow('version'),
+            ])
+        );
+        expect(pretty).to.deep.eq({});
+        expect(version).to.deep.eq({ value: '12.1' });
+        expect(backend.writes.length).to.eq(1);
+    });
+});
@@ -0,0 +1,180 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import {
+    CommandPriority,
+    CommandScheduler,
+    RequestContext,
+} from '../commandScheduler';
+import { isReadOnlyCommand, SingleFlight } from '../singleFlight';
+
+describe('SingleFlight', () => {
+    let singleFlight: SingleFlight;
+    let sent: string[];
+    let results: Array<(value: string) => void>;
+
+    beforeEach(() => {
+        singleFlight = new SingleFlight();
+        sent = [];
+        results = [];
+    });
+
+    function send(command: string, options?: object) {
+        return singleFlight.run(
+            command,
+            options,
+            () =>
+                new Promise<string>((resolve) => {
+                    sent.push(command);
+                    results.push(resolve);
+                })
+        );
+    }
+
+    it('recognizes read-only commands', () => {
+        expect(isReadOnlyCommand('-thread-info')).to.eq(true);
+        expect(isReadOnlyCommand('-stack-info-depth 100')).to.eq(true);
+        expect(isReadOnlyCommand('-thread-select 2')).to.eq(false);
+        expect(isReadOnlyCommand('-data-evaluate-expression x++')).to.eq(
+            false
+        );
+    });
+
+    it('shares identical read-only commands in flight', async () => {
+        const first = send('-stack-info-depth 100');
+        const second = send('-stack-info-depth 100');
+        expect(sent).to.deep.eq(['-stack-info-depth 100']);
+        results[0]('3');
+        expect(await first).to.eq('3');
+        expect(await second).to.eq('3');
+        expect(singleFlight.shared).to.eq(1);
+        expect(singleFlight.hitRate).to.eq(0.5);
+    });
+
+    it('sends again once the result arrived', async () => {
+        const first = send('-thread-info');
+        results[0]('threads');
+        await first;
+        send('-thread-info');
+        expect(sent).to.deep.eq(['-thread-info', '-thread-info']);
+    });
+
+    it('does not share across other commands', () => {
+        send('-stack-info-depth 100');
+        send('-thread-select 2');
+        send('-stack-info-depth 100');
+        expect(sent).to.deep.eq([
+            '-stack-info-depth 100',
+            '-thread-select 2',
+            '-stack-info-depth 100',
+        ]);
+    });
+
+    it('does not share after clear', () => {
+        send('-thread-info');
+        singleFlight.clear();
+        send('-thread-info');
+        expect(sent).to.deep.eq(['-thread-info', '-thread-info']);
+    });
+
+    it('does not share between different options', () => {
+        send('-thread-info', { lazy: true });
+        send('-thread-info');
+        send('-thread-info', { lazy: true });
+        expect(sent).to.deep.eq(['-thread-info', '-thread-info']);
+    });
+
+    describe('with cancellable requests', () => {
+        let scheduler: CommandScheduler;
+
+        beforeEach(() => {
+            scheduler = new CommandScheduler();
+        });
+
+        function schedule(command: string, request: RequestContext) {
+            return singleFlight.run(
+                command,
+                undefined,
+                (flight) =>
+                    new Promise<string>((resolve, reject) =>
+                        scheduler.push({
+                            command,
+                            priority: CommandPriority.Interactive,
+                            request: flight,
+                            send: () => resolve(command),
+                            drop: reject,
+                        })
+                    ),
+                request
+            );
+        }
+
+        it('keeps a shared command when only its first request is cancelled', async () => {
+            const first = { seq: 1, cancelled: false };
+            const second = { seq: 2, cancelled: false };
+            const results = [
+                schedule('-thread-info', first),
+                schedule('-thread-info', second),
+            ];
+            first.cancelled = true;
+            expect(scheduler.cancel(first)).to.eq(0);
+            scheduler.shift()?.send();
+            expect(await Promise.all(results)).to.deep.eq([
+                '-thread-info',
+                '-thread-info',
+            ]);
+        });
+
+        it('drops a shared command once all its requests are cancelled', async () => {
+            const first = { seq: 1, cancelled: false };
+            const second = { seq: 2, cancelled: false };
+            const results = [
+                schedule('-thread-info', first),
+                schedule('-thread-info', second),
+            ].map((result) => result.catch((err: Error) => err.message));
+            first.cancelled = true;
+            second.cancelled = true;
+            expect(scheduler.shift()).to.eq(undefined);
+            expect(await Promise.all(results)).to.deep.eq([
+                'cancelled',
+                'cancelled',
+            ]);
+        });
+
+        it('cancels a shared command with the last of its requests', async () => {
+            const first = { seq: 1, cancelled: false };
+            const second = { seq: 2, cancelled: false };
+            const sent: string[] = [];
+            const results = [
+                schedule('-thread-info', first),
+                schedule('-thread-info', second),
+                schedule('-thread-list-ids', second),
+            ].map((result) =>
+                result.then(
+                    (command) => sent.push(command),
+                    (err: Error) => err.message
+                )
+            );
+            first.cancelled = true;
+            expect(scheduler.cancel(first)).to.eq(0);
+            second.cancelled = true;
+            expect(scheduler.cancel(second)).to.eq(2);
+            expect(scheduler.size).to.eq(0);
+            expect(scheduler.shift()).to.eq(undefined);
+            expect(await Promise.all(results)).to.deep.eq([
+                'cancelled',
+                'cancelled',
+                'cancelled',
+            ]);
+            expect(sent).to.deep.eq([]);
+            expect(scheduler.cancelled).to.eq(2);
+        });
+    });
+});
@@ -111,6 +111,35 @@ describe('Stepping', async function () {
         });
     });
 
+    it('keeps the varobjs of the caller when stepping in', async () => {
+        const threads = await dc.threadsRequest();
+        const threadId = threads.body.threads[0].id;
+        const varobjs = async () =>
+            (await dc.customRequest('cdt-gdb-adapter/Stats')).body.commands
+                .varobjs as number;
+        const listMainVariables = async () => {
+            const { main } = await getFrameState(threadId);
+            expect(main).not.to.be.undefined;
+            const scopes = await dc.scopesRequest({ frameId: main?.id ?? 0 });
+            return dc.variablesRequest({
+                variablesReference: scopes.body.scopes[0].variablesReference,
+            });
+        };
+        const before = await listMainVariables();
+        const created = await varobjs();
+        await Promise.all([
+            dc.stepInRequest({ threadId, granularity: 'statement' }),
+            dc.waitForEvent('stopped'),
+        ]);
+        expectStackState(await getFrameState(threadId), {
+            elsewhereDefined: true,
+            line: lineTags['getFromElsewhere entry'],
+        });
+        const after = await listMainVariables();
+        expect(after.body.variables).to.deep.eq(before.body.variables);
+        expect(await varobjs()).to.eq(created);
+    });
+
     it('steps in by instruction', async () => {
         const threads = await dc.threadsRequest();
         const threadId = threads.body.threads[0].id;
@@ -18,6 +18,8 @@ import { CdtDebugClient } from './debugClient';
 import { compareVersions, getGdbVersion } from '../util';
 import { Runnable } from 'mocha';
 import { RequestArguments } from '../GDBDebugSession';
+// without the mocha hooks below, for the benchmarks too
+export { writeFakeGdb } from './fakeGdb';
 
 export interface Scope {
     thread: DebugProtocol.Thread;
@@ -555,4 +555,40 @@ describe('Variables Test Suite', function () {
             '[\n  "104 \'h\'",\n  "101 \'e\'",\n  "108 \'l\'",\n  "108 \'l\'",\n  "111 \'o\'",\n  "0 \'\\\\000\'"\n]'
         );
     });
+
+    it('updates all the variables with one command per stop', async function () {
+        const varUpdates = async () =>
+            (await dc.customRequest('cdt-gdb-adapter/Stats')).body.commands
+                .varUpdates as number;
+        let vr = scope.scopes.body.scopes[0].variablesReference;
+        await dc.variablesRequest({ variablesReference: vr });
+        const before = await varUpdates();
+        await dc.next(
+            { threadId: scope.thread.id },
+            { path: varsSrc, line: lineTags['STOP HERE'] + 1 }
+        );
+        scope = await getScopes(dc);
+        vr = scope.scopes.body.scopes[0].variablesReference;
+        const vars = await dc.variablesRequest({ variablesReference: vr });
+        verifyVariable(vars.body.variables[2], 'c', 'int', '3');
+        // new varobjs for watches and hovers, created up to date
+        for (const expression of ['a', 'a + b', 'c * 2', '&b', 'a == b']) {
+            await dc.evaluateRequest({
+                context: 'watch',
+                expression,
+                frameId: scope.frame.id,
+            });
+        }
+        await dc.variablesRequest({ variablesReference: vr });
+        expect(await varUpdates()).to.eq(before + 1);
+        // an assignment may change any value
+        await dc.evaluateRequest({
+            context: 'repl',
+            expression: 'b = 5',
+            frameId: scope.frame.id,
+        });
+        const changed = await dc.variablesRequest({ variablesReference: vr });
+        verifyVariable(changed.body.variables[1], 'b', 'int', '5');
+        expect(await varUpdates()).to.eq(before + 2);
+    });
 });
@@ -0,0 +1,216 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { expect } from 'chai';
+import { GDBBackend } from '../GDBBackend';
+import { MIVarCreateResponse } from '../mi/var';
+import { mayChangeValues, VarManager } from '../varManager';
+
+describe('VarManager', () => {
+    let commands: string[];
+    let changelist: any[];
+    let manager: VarManager;
+
+    beforeEach(() => {
+        commands = [];
+        changelist = [];
+        const gdb = {
+            sendCommand: (command: string) => {
+                commands.push(command);
+                return Promise.resolve(
+                    command.startsWith('-var-update') ? { changelist } : {}
+                );
+            },
+        } as unknown as GDBBackend;
+        manager = new VarManager(gdb);
+    });
+
+    function created(name: string): MIVarCreateResponse {
+        return { name, numchild: '0', value: '1', type: 'int' };
+    }
+
+    it('finds varobjs by expression and type, and by varname', () => {
+        const local = manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        const register = manager.addVar(
+            1,
+            'f3',
+            'x',
+            true,
+            false,
+            created('v2'),
+            'registers'
+        );
+        expect(manager.getVar(1, 'f3', 'x')).to.eq(local);
+        expect(manager.getVar(1, 'f3', 'x', 'registers')).to.eq(register);
+        expect(manager.getVarByName(1, 'f3', 'v2')).to.eq(register);
+        expect(manager.getVar(1, 'f4', 'x')).to.eq(undefined);
+        expect(manager.getVars(1, 'f3')).to.deep.eq([local, register]);
+    });
+
+    it('keeps the frames of each thread apart', () => {
+        manager.addVar(1, '2:main:', 'x', true, false, created('v1'));
+        manager.addVar(2, '2:main:', 'x', true, false, created('v2'));
+        manager.addVar(1, '3:f:0x401136', 'x', true, false, created('v3'));
+        expect(manager.getVar(1, '2:main:', 'x')?.varname).to.eq('v1');
+        expect(manager.getVar(2, '2:main:', 'x')?.varname).to.eq('v2');
+        expect(manager.getVar(1, '3:f:0x401136', 'x')?.varname).to.eq('v3');
+        expect(manager.getVar(2, '3:f:0x401136', 'x')).to.eq(undefined);
+    });
+
+    it('removes varobjs from gdb and from its indexes', async () => {
+        manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        manager.addVar(1, 'f3', 'y', true, false, created('v2'));
+        await manager.removeVar(1, 'f3', 'v1');
+        expect(commands).to.deep.eq(['-var-delete v1']);
+        expect(manager.getVar(1, 'f3', 'x')).to.eq(undefined);
+        expect(manager.getVarByName(1, 'f3', 'v1')).to.eq(undefined);
+        expect(manager.getVars(1, 'f3')?.map((v) => v.varname)).to.deep.eq([
+            'v2',
+        ]);
+    });
+
+    it('deletes a varobj and its children with one command', async () => {
+        const parent = manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        const child = manager.addVar(1, 'f3', 'x.a', true, true, created('v2'));
+        parent.children.push(child);
+        await manager.removeVar(1, 'f3', 'v1');
+        expect(commands).to.deep.eq(['-var-delete v1']);
+        expect(manager.getVarByName(1, 'f3', 'v2')).to.eq(undefined);
+        expect(manager.size).to.eq(0);
+        expect(manager.frames).to.eq(0);
+    });
+
+    it('evicts the least recently used frames beyond the limit', () => {
+        manager.limit = 3;
+        manager.addVar(1, 'f1', 'x', true, false, created('v1'));
+        manager.addVar(1, 'f2', 'x', true, false, created('v2'));
+        manager.addVar(1, 'f2', 'y', true, false, created('v3'));
+        manager.programStopped();
+        // the first frame is used again, the second is the oldest now
+        manager.getVar(1, 'f1', 'x');
+        manager.addVar(1, 'f3', 'x', true, false, created('v4'));
+        expect(commands).to.deep.eq(['-var-delete v2', '-var-delete v3']);
+        expect(manager.getVars(1, 'f2')).to.eq(undefined);
+        expect(manager.getVar(1, 'f1', 'x')?.varname).to.eq('v1');
+        expect(manager.size).to.eq(2);
+        expect(manager.evicted).to.eq(2);
+    });
+
+    it('keeps the frame being added to', () => {
+        manager.limit = 1;
+        manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        manager.addVar(1, 'f3', 'y', true, false, created('v2'));
+        expect(commands).to.deep.eq([]);
+        expect(manager.size).to.eq(2);
+    });
+
+    it('keeps the frames used since the program stopped', () => {
+        manager.limit = 1;
+        manager.addVar(1, 'f1', 'x', true, false, created('v1'));
+        manager.addVar(1, 'f2', 'x', true, false, created('v2'));
+        expect(commands).to.deep.eq([]);
+        manager.programStopped();
+        manager.addVar(1, 'f3', 'x', true, false, created('v3'));
+        expect(commands).to.deep.eq(['-var-delete v1', '-var-delete v2']);
+        expect(manager.size).to.eq(1);
+    });
+
+    it('counts the children gdb listed toward the limit', () => {
+        manager.limit = 3;
+        manager.addVar(1, 'f1', 'x', true, false, created('v1'));
+        manager.addChildren(1, 'f1', 'v1', 2);
+        // listing them again creates none
+        manager.addChildren(1, 'f1', 'v1', 2);
+        expect(manager.size).to.eq(3);
+        manager.programStopped();
+        manager.addVar(1, 'f2', 'x', true, false, created('v2'));
+        expect(commands).to.deep.eq(['-var-delete v1']);
+        expect(manager.size).to.eq(1);
+        expect(manager.evicted).to.eq(3);
+    });
+
+    it('forgets the children listed with their varobj', async () => {
+        manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        manager.addVar(1, 'f3', 'y', true, false, created('v10'));
+        manager.addChildren(1, 'f3', 'v1', 2);
+        manager.addChildren(1, 'f3', 'v1.a', 3);
+        manager.addChildren(1, 'f3', 'v10', 1);
+        expect(manager.size).to.eq(8);
+        await manager.removeVar(1, 'f3', 'v1');
+        expect(manager.size).to.eq(2);
+    });
+
+    it('deletes the varobjs of a thread that exited', async () => {
+        manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        manager.addVar(1, 'f2', 'x', true, false, created('v2'));
+        manager.addVar(2, 'f3', 'x', true, false, created('v3'));
+        await manager.removeThread(1);
+        expect(commands).to.deep.eq(['-var-delete v1', '-var-delete v2']);
+        expect(manager.getVarByName(2, 'f3', 'v3')?.varname).to.eq('v3');
+        expect(manager.frames).to.eq(1);
+    });
+
+    it('updates all the varobjs at once until invalidated', async () => {
+        const x = manager.addVar(1, 'f3', 'x', true, false, created('v1'));
+        const y = manager.addVar(1, 'f3', 'y', true, false, created('v2'));
+        changelist = [
+            { name: 'v1', value: '42', in_scope: 'true' },
+            { name: 'v1.child', value: '7', in_scope: 'true' },
+            { name: 'v2', in_scope: 'false' },
+        ];
+        await Promise.all([manager.refresh(), manager.refresh()]);
+        await manager.refresh();
+        expect(commands).to.deep.eq(['-var-update 1 *']);
+        expect(x.value).to.eq('42');
+        expect(y.outOfScope).to.eq(true);
+
+        manager.invalidate();
+        await manager.refresh();
+        expect(manager.updates).to.eq(2);
+    });
+
+    it('tells the commands that may change values', () => {
+        expect(mayChangeValues('-stack-list-variables --simple-values')).to.eq(
+            false
+        );
+        expect(mayChangeValues('-var-list-children var1')).to.eq(false);
+        expect(mayChangeValues('-break-insert main')).to.eq(false);
+        expect(
+            mayChangeValues('-data-read-memory-bytes -o 0 "&a" 4')
+        ).to.eq(false);
+        expect(mayChangeValues('-var-assign var1 3')).to.eq(true);
+        expect(mayChangeValues('-exec-next')).to.eq(true);
+        expect(
+            mayChangeValues('-interpreter-exec console "print x = 1"')
+        ).to.eq(true);
+    });
+
+    it('tells the expressions that may change values', () => {
+        const create = (expression: string) =>
+            mayChangeValues(
+                `-var-create --thread 1 --frame 0 - * "${expression}"`
+            );
+        expect(create('x')).to.eq(false);
+        expect(create('a == b && c <= d || e != f')).to.eq(false);
+        expect(create('&(r.z)')).to.eq(false);
+        expect(create('(char)f[1]')).to.eq(false);
+        expect(create('x = 3')).to.eq(true);
+        expect(create('x += 3')).to.eq(true);
+        expect(create('x <<= 1')).to.eq(true);
+        expect(create('x++')).to.eq(true);
+        expect(create('--x')).to.eq(true);
+        expect(create('f(1)')).to.eq(true);
+        expect(mayChangeValues('-data-evaluate-expression "&(a)"')).to.eq(
+            false
+        );
+        expect(mayChangeValues('-data-evaluate-expression "g()"')).to.eq(
+            true
+        );
+    });
+});
@@ -9,6 +9,7 @@
  *********************************************************************/
 
 import { GDBBackend } from '../GDBBackend';
+import { excerpt } from '../util';
 import { MIResponse, MIRegisterValueInfo } from './base';
 
 interface MIDataReadMemoryBytesResponse {
@@ -19,6 +20,16 @@ interface MIDataReadMemoryBytesResponse {
         contents: string;
     }>;
 }
+
+export interface MIDataReadMemoryBytesBufferResponse {
+    memory: Array<{
+        begin: string;
+        end: string;
+        offset: string;
+        data: Buffer;
+    }>;
+}
+
 interface MIDataDisassembleAsmInsn {
     address: string;
     // func-name in MI
@@ -61,6 +72,32 @@ export function sendDataReadMemoryBytes(
     );
 }
 
+/**
+ * Like sendDataReadMemoryBytes, but the contents of the memory are decoded
+ * by the parser straight into Buffers, which avoids creating large strings.
+ */
+export async function sendDataReadMemoryBytesAsBuffer(
+    gdb: GDBBackend,
+    address: string,
+    size: number,
+    offset = 0
+): Promise<MIDataReadMemoryBytesBufferResponse> {
+    const result = await gdb.sendCommand<any>(
+        `-data-read-memory-bytes -o ${offset} "${address}" ${size}`,
+        { hexContents: true }
+    );
+    for (const memory of result.memory) {
+        if (!memory.data) {
+            // The parser only decodes well-formed hex
+            throw new Error(
+                'Received ill-formed hex input: ' + excerpt(memory.contents)
+            );
+        }
+        delete memory.contents;
+    }
+    return result;
+}
+
 export function sendDataWriteMemoryBytes(
     gdb: GDBBackend,
     memoryReference: string,
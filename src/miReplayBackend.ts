@@ -0,0 +1,212 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { PassThrough, Writable } from 'stream';
+import { GDBBackend } from './GDBBackend';
+import {
+    AttachRequestArguments,
+    LaunchRequestArguments,
+} from './GDBDebugSession';
+import { MIRecording, MITraceDirection } from './miTrace';
+
+interface RecordedReply {
+    /** Token the command had in the recording */
+    token: number;
+    /** Lines gdb sent in reply, the result record included */
+    lines: Buffer[];
+}
+
+/**
+ * A backend that serves recorded MI traffic instead of talking to gdb,
+ * for benchmarks and tests that must run without gdb.
+ *
+ * Each command is answered with the output that followed the same command
+ * in the recording, with the token of the result record rewritten. When a
+ * command was recorded several times, its replies are used in turn, and
+ * they start over once they have all been used. Commands that were not
+ * recorded get an error and are listed in `misses`.
+ *
+ * Use it by overriding GDBDebugSession.createBackend.
+ */
+export class MIReplayBackend extends GDBBackend {
+    /** Commands that had no recorded reply */
+    public readonly misses: string[] = [];
+
+    protected replies = new Map<string, RecordedReply[]>();
+    protected nextReply = new Map<string, number>();
+    protected initialOutput: Buffer[] = [];
+    protected input = new PassThrough();
+
+    constructor(protected recording: MIRecording) {
+        super();
+        this.indexRecording();
+    }
+
+    public async spawn(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ) {
+        this.gdbVersion = this.recording.metadata.gdbVersion;
+        this.hardwareBreakpoint = requestArgs.hardwareBreakpoint ? true : false;
+        this.out = new Writable({
+            write: (chunk: Buffer, _encoding, callback) => {
+                this.replay(chunk.toString());
+                callback();
+            },
+            // pipelined commands, gdb would read them at once
+            writev: (chunks, callback) => {
+                this.replay(chunks.map(({ chunk }) => chunk).join(''));
+                callback();
+            },
+        });
+        const ready = this.parser.parse(this.input);
+        for (const line of this.initialOutput) {
+            this.push(line);
+        }
+        // in case the recording started after gdb was ready
+        this.push(Buffer.from('(gdb) '));
+        await ready;
+        // the setup has to be the recorded one for the commands to match
+        const metadata = this.recording.metadata;
+        await this.setNonStopMode(
+            metadata.gdbNonStop ?? requestArgs.gdbNonStop
+        );
+        await this.setAsyncMode(metadata.gdbAsync ?? requestArgs.gdbAsync);
+    }
+
+    public spawnInClientTerminal(
+        requestArgs: LaunchRequestArguments | AttachRequestArguments
+    ) {
+        return this.spawn(requestArgs);
+    }
+
+    public async supportsNewUi(): Promise<boolean> {
+        this.gdbVersion = this.recording.metadata.gdbVersion;
+        return this.gdbVersionAtLeast('7.12');
+    }
+
+    public pause(threadId?: number) {
+        if (!this.gdbAsync) {
+            throw new Error('Cannot interrupt a replayed session');
+        }
+        super.pause(threadId);
+    }
+
+    /**
+     * Split the recording into the replies to each command.
+     *
+     * A reply is made of the lines received until the next command was
+     * sent. Result records are moved to the reply of the command with the
+     * same token, for commands that were sent before the previous one
+     * completed.
+     */
+    protected indexRecording() {
+        const entries = this.recording.entries;
+        const results = new Map<number, Buffer>();
+        for (const entry of entries) {
+            if (
+                entry.direction === MITraceDirection.In &&
+                entry.token >= 0 &&
+                isResultRecord(entry.data)
+            ) {
+                results.set(entry.token, entry.data);
+            }
+        }
+
+        let current: RecordedReply | undefined;
+        for (const entry of entries) {
+            if (entry.direction === MITraceDirection.Out) {
+                this.completeReply(current, results);
+                current = { token: entry.token, lines: [] };
+                const command = entry.data.toString();
+                const replies = this.replies.get(command);
+                if (replies) {
+                    replies.push(current);
+                } else {
+                    this.replies.set(command, [current]);
+                }
+            } else if (!current) {
+                this.initialOutput.push(entry.data);
+            } else if (
+                entry.token < 0 ||
+                !isResultRecord(entry.data) ||
+                entry.token === current.token
+            ) {
+                current.lines.push(entry.data);
+                if (entry.token === current.token) {
+                    results.delete(current.token);
+                }
+            }
+        }
+        this.completeReply(current, results);
+    }
+
+    protected completeReply(
+        reply: RecordedReply | undefined,
+        results: Map<number, Buffer>
+    ) {
+        const result = reply && results.get(reply.token);
+        if (reply && result) {
+            reply.lines.push(result);
+        }
+    }
+
+    protected replay(data: string) {
+        for (const line of data.split('\n')) {
+            const match = /^(\d+)(.*)$/.exec(line);
+            if (!match) {
+                continue;
+            }
+            const [, token, command] = match;
+            const replies = this.replies.get(command);
+            if (!replies) {
+                this.misses.push(command);
+                const msg = `No recorded reply for ${command}`;
+                this.push(
+                    Buffer.from(`${token}^error,msg=${JSON.stringify(msg)}`)
+                );
+                continue;
+            }
+            const index = this.nextReply.get(command) ?? 0;
+            this.nextReply.set(command, (index + 1) % replies.length);
+            const reply = replies[index];
+            const recordedToken = reply.token.toString();
+            for (const recorded of reply.lines) {
+                const prefix = recorded.subarray(0, recordedToken.length);
+                const next = recorded[recordedToken.length];
+                if (
+                    prefix.toString() === recordedToken &&
+                    !(next >= 0x30 && next <= 0x39)
+                ) {
+                    // the reply to this command, give it the new token
+                    this.push(
+                        Buffer.concat([
+                            Buffer.from(token),
+                            recorded.subarray(recordedToken.length),
+                        ])
+                    );
+                } else {
+                    this.push(recorded);
+                }
+            }
+        }
+    }
+
+    protected push(line: Buffer) {
+        this.input.write(Buffer.concat([line, Buffer.from('\n')]));
+    }
+}
+
+function isResultRecord(line: Buffer) {
+    for (let i = 0; i < line.length; i++) {
+        if (line[i] < 0x30 || line[i] > 0x39) {
+            return line[i] === 0x5e /* ^ */;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,365 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+import { logger } from '@vscode/debugadapter/lib/logger';
+import * as fs from 'fs';
+import { performance } from 'perf_hooks';
+
+export enum MITraceDirection {
+    /** Sent to gdb */
+    Out = 0,
+    /** Received from gdb */
+    In = 1,
+}
+
+export interface MITraceEntry {
+    /** Milliseconds since the epoch */
+    time: number;
+    direction: MITraceDirection;
+    /** The token of the command, -1 if there is none */
+    token: number;
+    data: string;
+}
+
+/** An entry of an MI recording, data is the raw line without terminator */
+export interface MIRecordedEntry {
+    time: number;
+    direction: MITraceDirection;
+    token: number;
+    data: Buffer;
+}
+
+export interface MIRecordingMetadata {
+    /** Version of the recorded gdb, as returned by getGdbVersion */
+    gdbVersion?: string;
+    /** Modes requested in the launch arguments */
+    gdbNonStop?: boolean;
+    gdbAsync?: boolean;
+}
+
+export interface MIRecording {
+    metadata: MIRecordingMetadata;
+    entries: MIRecordedEntry[];
+}
+
+// time (float64), token (int32), direction (uint8), length (uint32)
+const HEADER_SIZE = 17;
+
+const RECORDING_MAGIC = Buffer.from('CDTMIREC');
+
+function writeHeader(
+    target: Buffer,
+    offset: number,
+    direction: MITraceDirection,
+    token: number,
+    length: number
+) {
+    const time = performance.timeOrigin + performance.now();
+    target.writeDoubleLE(time, offset);
+    target.writeInt32LE(token, offset + 8);
+    target.writeUInt8(direction, offset + 12);
+    target.writeUInt32LE(length, offset + 13);
+}
+
+/**
+ * Writes the MI traffic of a session to a file, to be replayed with
+ * MIReplayBackend.
+ *
+ * The file starts with a magic number and the metadata as JSON, then has
+ * one entry per line, with the same binary header as the trace buffer.
+ * Entries are written once per turn of the event loop.
+ */
+export class MIRecorder {
+    protected pending: Buffer[] = [];
+    protected fd?: number;
+
+    constructor(path: string, metadata: MIRecordingMetadata) {
+        this.fd = fs.openSync(path, 'w');
+        const json = Buffer.from(JSON.stringify(metadata));
+        const length = Buffer.alloc(4);
+        length.writeUInt32LE(json.length);
+        fs.writeSync(this.fd, Buffer.concat([RECORDING_MAGIC, length, json]));
+    }
+
+    public record(direction: MITraceDirection, token: number, data: Buffer) {
+        const entry = Buffer.allocUnsafe(HEADER_SIZE + data.length);
+        writeHeader(entry, 0, direction, token, data.length);
+        data.copy(entry, HEADER_SIZE);
+        if (this.pending.push(entry) === 1) {
+            setImmediate(() => this.flush());
+        }
+    }
+
+    public flush() {
+        if (this.fd !== undefined && this.pending.length) {
+            fs.writeSync(this.fd, Buffer.concat(this.pending));
+        }
+        this.pending = [];
+    }
+
+    public close() {
+        this.flush();
+        if (this.fd !== undefined) {
+            fs.closeSync(this.fd);
+            this.fd = undefined;
+        }
+    }
+}
+
+/**
+ * Read a file written by MIRecorder.
+ */
+export function readMIRecording(path: string): MIRecording {
+    const file = fs.readFileSync(path);
+    if (
+        file.length < RECORDING_MAGIC.length + 4 ||
+        !file.subarray(0, RECORDING_MAGIC.length).equals(RECORDING_MAGIC)
+    ) {
+        throw new Error(`${path} is not an MI recording`);
+    }
+    let offset = RECORDING_MAGIC.length;
+    const metadataLength = file.readUInt32LE(offset);
+    offset += 4;
+    const metadata = JSON.parse(
+        file.toString('utf8', offset, offset + metadataLength)
+    );
+    offset += metadataLength;
+
+    const entries: MIRecordedEntry[] = [];
+    while (offset + HEADER_SIZE <= file.length) {
+        const length = file.readUInt32LE(offset + 13);
+        const end = offset + HEADER_SIZE + length;
+        if (end > file.length) {
+            // the recording was interrupted
+            break;
+        }
+        entries.push({
+            time: file.readDoubleLE(offset),
+            token: file.readInt32LE(offset + 8),
+            direction: file.readUInt8(offset + 12),
+            data: file.subarray(offset + HEADER_SIZE, end),
+        });
+        offset = end;
+    }
+    return { metadata, entries };
+}
+
+/**
+ * Tracing of the MI traffic with gdb.
+ *
+ * Raw records are copied to a fixed-size ring buffer, which keeps the most
+ * recent traffic. They are only formatted when the buffer is dumped. With
+ * `verbose`, the records are also logged as they come, like the adapter
+ * always did in verbose mode.
+ */
+export class MITrace {
+    /** Log the traffic with logger.verbose */
+    public verbose = false;
+
+    protected buffer?: Buffer;
+    protected header = Buffer.alloc(HEADER_SIZE);
+    // offset of the oldest entry
+    protected start = 0;
+    // offset where the next entry is written
+    protected end = 0;
+    protected used = 0;
+    protected entries = 0;
+    protected recorder?: MIRecorder;
+
+    get enabled() {
+        return (
+            this.verbose ||
+            this.buffer !== undefined ||
+            this.recorder !== undefined
+        );
+    }
+
+    /**
+     * Set the size of the ring buffer in bytes, 0 to disable it. The
+     * current content is discarded.
+     */
+    public setBufferSize(size: number) {
+        this.buffer = size > HEADER_SIZE ? Buffer.alloc(size) : undefined;
+        this.start = this.end = this.used = this.entries = 0;
+    }
+
+    /**
+     * Record all the MI traffic to path, until stopRecording is called.
+     */
+    public startRecording(path: string, metadata: MIRecordingMetadata) {
+        this.stopRecording();
+        this.recorder = new MIRecorder(path, metadata);
+    }
+
+    public stopRecording() {
+        this.recorder?.close();
+        this.recorder = undefined;
+    }
+
+    public traceOut(token: number, command: string) {
+        if (this.verbose) {
+            logger.verbose(`GDB command: ${token} ${command}`);
+        }
+        if (this.buffer || this.recorder) {
+            const data = Buffer.from(command);
+            if (this.buffer) {
+                this.append(MITraceDirection.Out, token, data);
+            }
+            this.recorder?.record(MITraceDirection.Out, token, data);
+        }
+    }
+
+    public traceIn(line: string | Buffer) {
+        if (this.verbose) {
+            this.logIn(line.toString());
+        }
+        if (this.buffer || this.recorder) {
+            const token = leadingToken(line);
+            const data = typeof line === 'string' ? Buffer.from(line) : line;
+            if (this.buffer) {
+                this.append(MITraceDirection.In, token, data);
+            }
+            this.recorder?.record(MITraceDirection.In, token, data);
+        }
+    }
+
+    /**
+     * Format the content of the ring buffer, oldest entry first.
+     */
+    public dump(): string[] {
+        return this.read().map((entry) => {
+            const time = new Date(entry.time).toISOString();
+            // Records from gdb already start with their token
+            return entry.direction === MITraceDirection.Out
+                ? `${time} -> ${entry.token}${entry.data}`
+                : `${time} <- ${entry.data}`;
+        });
+    }
+
+    /**
+     * Write the content of the ring buffer to the log, if it is enabled.
+     */
+    public dumpToLog(reason: string) {
+        if (!this.buffer || this.entries === 0) {
+            return;
+        }
+        logger.error(`${reason}, last MI traffic:\n${this.dump().join('\n')}`);
+    }
+
+    public read(): MITraceEntry[] {
+        const entries: MITraceEntry[] = [];
+        if (!this.buffer) {
+            return entries;
+        }
+        let offset = this.start;
+        for (let i = 0; i < this.entries; i++) {
+            this.copyOut(offset, this.header);
+            const length = this.header.readUInt32LE(13);
+            const data = Buffer.alloc(length);
+            this.copyOut((offset + HEADER_SIZE) % this.buffer.length, data);
+            entries.push({
+                time: this.header.readDoubleLE(0),
+                token: this.header.readInt32LE(8),
+                direction: this.header.readUInt8(12),
+                data: data.toString(),
+            });
+            offset = (offset + HEADER_SIZE + length) % this.buffer.length;
+        }
+        return entries;
+    }
+
+    protected logIn(line: string) {
+        const token = line.match(/^\d*/)?.[0] ?? '';
+        const rest = line.substr(token.length + 1);
+        switch (line.charAt(token.length)) {
+            case '^':
+                for (let i = 0; i < rest.length; i += 1000) {
+                    const msg = i === 0 ? 'result' : '-cont-';
+                    logger.verbose(
+                        `GDB ${msg}: ${token} ${rest.substr(i, 1000)}`
+                    );
+                }
+                break;
+            case '=':
+                logger.verbose('GDB notify async: ' + rest);
+                break;
+            case '*':
+                logger.verbose('GDB exec async: ' + rest);
+                break;
+            case '+':
+                logger.verbose('GDB status async: ' + rest);
+                break;
+            // Stream records are sent to the client as output events
+        }
+    }
+
+    protected append(
+        direction: MITraceDirection,
+        token: number,
+        data: Buffer
+    ) {
+        const buffer = this.buffer as Buffer;
+        if (data.length > buffer.length - HEADER_SIZE) {
+            data = data.subarray(0, buffer.length - HEADER_SIZE);
+        }
+        const size = HEADER_SIZE + data.length;
+        while (this.used + size > buffer.length) {
+            this.copyOut(this.start, this.header);
+            const evicted = HEADER_SIZE + this.header.readUInt32LE(13);
+            this.start = (this.start + evicted) % buffer.length;
+            this.used -= evicted;
+            this.entries--;
+        }
+
+        writeHeader(this.header, 0, direction, token, data.length);
+        this.copyIn(this.header);
+        this.copyIn(data);
+        this.used += size;
+        this.entries++;
+    }
+
+    /** Copy data at the end of the ring buffer */
+    protected copyIn(data: Buffer) {
+        const buffer = this.buffer as Buffer;
+        const first = Math.min(data.length, buffer.length - this.end);
+        data.copy(buffer, this.end, 0, first);
+        data.copy(buffer, 0, first);
+        this.end = (this.end + data.length) % buffer.length;
+    }
+
+    /** Copy from the ring buffer at offset to target */
+    protected copyOut(offset: number, target: Buffer) {
+        const buffer = this.buffer as Buffer;
+        const first = Math.min(target.length, buffer.length - offset);
+        buffer.copy(target, 0, offset, offset + first);
+        buffer.copy(target, first, 0, target.length - first);
+    }
+}
+
+// digits of the longest token kept, so that it fits in the header
+const MAX_TOKEN_DIGITS = 9;
+
+/**
+ * The token at the start of an MI record, -1 if it has none. Longer runs
+ * of digits, like console output that starts with a number, have none.
+ */
+function leadingToken(line: string | Buffer): number {
+    let token = -1;
+    for (let i = 0; i < line.length; i++) {
+        const c = typeof line === 'string' ? line.charCodeAt(i) : line[i];
+        if (c < 0x30 || c > 0x39) {
+            break;
+        }
+        if (i === MAX_TOKEN_DIGITS) {
+            return -1;
+        }
+        token = (token < 0 ? 0 : token * 10) + c - 0x30;
+    }
+    return token;
+}
@@ -0,0 +1,58 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/**
+ * Hands out read buffers carved from large slabs, the way fs.ReadStream
+ * does, instead of allocating and zeroing a buffer per read.
+ *
+ * Reserve room for a read, then commit what the read filled: the bytes
+ * committed are returned as a view of the slab, and the rest of the room
+ * is reused by the next read. A slab is garbage collected once all its
+ * views are.
+ */
+export class BufferPool {
+    /** Slabs allocated so far */
+    public slabs = 0;
+
+    protected slab?: Buffer;
+    protected offset = 0;
+
+    /**
+     * @param slabSize size of the slabs
+     * @param minimum room below which a read gets a new slab
+     */
+    constructor(
+        public readonly slabSize = 64 * 1024,
+        public readonly minimum = 4 * 1024
+    ) {}
+
+    /** Room for a read of up to size bytes */
+    public reserve(size: number): Buffer {
+        if (size > this.slabSize) {
+            this.slabs++;
+            return Buffer.allocUnsafeSlow(size);
+        }
+        if (!this.slab || this.slab.length - this.offset < this.minimum) {
+            this.slabs++;
+            this.slab = Buffer.allocUnsafeSlow(this.slabSize);
+            this.offset = 0;
+        }
+        const end = Math.min(this.slab.length, this.offset + size);
+        return this.slab.subarray(this.offset, end);
+    }
+
+    /** Keep the first length bytes of the buffer reserve returned */
+    public commit(buffer: Buffer, length: number): Buffer {
+        if (this.slab && buffer.buffer === this.slab.buffer) {
+            this.offset += length;
+        }
+        return buffer.subarray(0, length);
+    }
+}
@@ -0,0 +1,206 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Hex and base64 conversions of memory contents, validating as they go
+ * instead of re-encoding the result to check it.
+ */
+namespace codec {
+
+static const char base64_digits[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char hex_digits[] = "0123456789abcdef";
+
+/** Values of hex and base64 digits, 0xff for other characters */
+struct digit_values {
+  uint8_t hex[256];
+  uint8_t base64[256];
+
+  digit_values() {
+    for (int i = 0; i < 256; i++)
+      hex[i] = base64[i] = 0xff;
+    for (int i = 0; i < 16; i++) {
+      hex[static_cast<uint8_t>(hex_digits[i])] = i;
+      hex[static_cast<uint8_t>("0123456789ABCDEF"[i])] = i;
+    }
+    for (int i = 0; i < 64; i++)
+      base64[static_cast<uint8_t>(base64_digits[i])] = i;
+  }
+};
+
+static const digit_values values;
+
+#ifdef __SSE2__
+/**
+ * Decode 16 hex digits into 8 bytes, in the low half of the result.
+ *
+ * @returns false if they are not all hex digits
+ */
+static inline bool decode_hex16(const char *src, __m128i &bytes) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+  __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+  __m128i letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)),
+                                 _mm_set1_epi8('a'));
+  // unsigned x <= n when x - n saturates to 0
+  __m128i is_digit =
+      _mm_cmpeq_epi8(_mm_subs_epu8(digits, _mm_set1_epi8(9)), zero);
+  __m128i is_letter =
+      _mm_cmpeq_epi8(_mm_subs_epu8(letters, _mm_set1_epi8(5)), zero);
+  if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff)
+    return false;
+  __m128i nibbles = _mm_or_si128(
+      _mm_and_si128(is_digit, digits),
+      _mm_and_si128(is_letter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+  // each 16-bit lane holds the high nibble then the low one
+  __m128i high = _mm_and_si128(nibbles, _mm_set1_epi16(0x00ff));
+  __m128i low = _mm_srli_epi16(nibbles, 8);
+  bytes = _mm_or_si128(_mm_slli_epi16(high, 4), low);
+  return true;
+}
+#endif
+
+/**
+ * Decode length hex digits, an even number, into length / 2 bytes.
+ *
+ * @returns false if src has characters that are not hex digits
+ */
+static inline bool decode_hex(const char *src, size_t length, uint8_t *dst) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 32 <= length; i += 32, dst += 16) {
+    __m128i first, second;
+    if (!decode_hex16(src + i, first) || !decode_hex16(src + i + 16, second))
+      return false;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_packus_epi16(first, second));
+  }
+#endif
+  uint8_t invalid = 0;
+  for (; i < length; i += 2) {
+    uint8_t high = values.hex[static_cast<uint8_t>(src[i])];
+    uint8_t low = values.hex[static_cast<uint8_t>(src[i + 1])];
+    invalid |= high | low;
+    *dst++ = static_cast<uint8_t>(high << 4 | low);
+  }
+  // 0xff is the only value with the high bit set
+  return !(invalid & 0x80);
+}
+
+/** Append the base64 of length bytes to out, padded if final */
+static inline void encode_base64(const uint8_t *src, size_t length,
+                                 std::string &out) {
+  size_t i = 0;
+  for (; i + 3 <= length; i += 3) {
+    uint32_t group = src[i] << 16 | src[i + 1] << 8 | src[i + 2];
+    char chars[4] = {base64_digits[group >> 18],
+                     base64_digits[group >> 12 & 0x3f],
+                     base64_digits[group >> 6 & 0x3f],
+                     base64_digits[group & 0x3f]};
+    out.append(chars, 4);
+  }
+  if (i < length) {
+    uint32_t group = src[i] << 16 | (i + 1 < length ? src[i + 1] << 8 : 0);
+    char chars[4] = {base64_digits[group >> 18],
+                     base64_digits[group >> 12 & 0x3f],
+                     i + 1 < length ? base64_digits[group >> 6 & 0x3f] : '=',
+                     '='};
+    out.append(chars, 4);
+  }
+}
+
+/**
+ * Convert hex digits to base64 in one pass, without holding all the bytes.
+ *
+ * @returns false if hex is not an even number of hex digits
+ */
+static inline bool hex_to_base64(const char *hex, size_t length,
+                                 std::string &out) {
+  if (length % 2)
+    return false;
+  // a multiple of 3 bytes, so that only the last block is padded
+  const size_t BLOCK = 3 * 1024;
+  uint8_t bytes[BLOCK];
+  out.reserve((length / 2 + 2) / 3 * 4);
+  for (size_t i = 0; i < length; i += 2 * BLOCK) {
+    size_t count = length - i < 2 * BLOCK ? (length - i) / 2 : BLOCK;
+    if (!decode_hex(hex + i, 2 * count, bytes))
+      return false;
+    encode_base64(bytes, count, out);
+  }
+  return true;
+}
+
+/** Append the first count of the 6 hex digits of a 24-bit group */
+static inline void append_hex(uint32_t group, size_t count, std::string &out) {
+  char chars[6];
+  for (size_t i = 0; i < 6; i++)
+    chars[i] = hex_digits[group >> (20 - 4 * i) & 0xf];
+  out.append(chars, count);
+}
+
+/**
+ * Convert base64 to hex digits in one pass. Only the canonical base64 of
+ * some bytes is accepted: the padding may be left out, but the bits it
+ * would pad must be zero, as Buffer would encode them.
+ *
+ * @returns false if base64 is not canonical base64, empty input is valid
+ */
+static inline bool base64_to_hex(const char *base64, size_t length,
+                                 std::string &out) {
+  size_t padding = 0;
+  while (padding < 2 && length > padding && base64[length - padding - 1] == '=')
+    padding++;
+  if (padding && length % 4)
+    return false;
+  length -= padding;
+  if (length % 4 == 1)
+    return false;
+
+  out.reserve(length / 4 * 6 + 4);
+  uint8_t invalid = 0;
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    uint8_t a = values.base64[static_cast<uint8_t>(base64[i])];
+    uint8_t b = values.base64[static_cast<uint8_t>(base64[i + 1])];
+    uint8_t c = values.base64[static_cast<uint8_t>(base64[i + 2])];
+    uint8_t d = values.base64[static_cast<uint8_t>(base64[i + 3])];
+    invalid |= a | b | c | d;
+    uint32_t group = a << 18 | b << 12 | c << 6 | d;
+    append_hex(group, 6, out);
+  }
+  if (i < length) {
+    // 2 or 3 characters left, for 1 or 2 bytes
+    uint8_t a = values.base64[static_cast<uint8_t>(base64[i])];
+    uint8_t b = values.base64[static_cast<uint8_t>(base64[i + 1])];
+    uint8_t c = i + 2 < length
+                    ? values.base64[static_cast<uint8_t>(base64[i + 2])]
+                    : 0;
+    invalid |= a | b | c;
+    uint32_t group = a << 18 | b << 12 | c << 6;
+    size_t bytes = length - i - 1;
+    // the bits after the last byte must be zero
+    if (group & (bytes == 1 ? 0xffff : 0xff))
+      return false;
+    append_hex(group, 2 * bytes, out);
+  }
+  return !(invalid & 0x80);
+}
+
+} // namespace codec
@@ -0,0 +1,164 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/*
+ * Echoes bursts of MI commands through a ptmx/pts pair, like pty.spec.ts
+ * does, with File and with the File it replaced, which allocated a
+ * buffer per read and wrote each chunk with its own system call.
+ * Reports the throughput and the buffers and write calls of each.
+ *
+ * Needs the native addon: yarn build, then yarn bench:file.
+ */
+
+import * as fs from 'fs';
+import { Duplex, Readable, Writable } from 'stream';
+import { bench, formatBytes } from '../benchmarks/harness';
+import { File } from './file';
+
+interface PtyHandles {
+    master_fd: number;
+    slave_name: string;
+}
+
+/** The File before buffers were pooled and writes batched */
+class LegacyFile {
+    public allocations = 0;
+    protected _duplex: Duplex;
+
+    get reader(): Readable {
+        return this._duplex;
+    }
+
+    get writer(): Writable {
+        return this._duplex;
+    }
+
+    constructor(public fd: number) {
+        // eslint-disable-next-line @typescript-eslint/no-this-alias
+        const _this = this;
+        this._duplex = new Duplex({
+            read(size) {
+                _this.allocations++;
+                fs.read(
+                    fd,
+                    Buffer.alloc(size),
+                    0,
+                    size,
+                    null,
+                    (err, bytesRead, buffer) => {
+                        if (err) {
+                            this.push(null);
+                        } else {
+                            this.push(buffer.slice(0, bytesRead));
+                        }
+                    }
+                );
+            },
+            write(chunk, encoding, callback) {
+                const buffer = Buffer.isBuffer(chunk)
+                    ? chunk
+                    : Buffer.from(chunk, encoding);
+                fs.write(fd, buffer, (err) => callback(err));
+            },
+        });
+    }
+}
+
+interface Endpoint {
+    allocations: number;
+    reader: Readable;
+    writer: Writable;
+}
+
+// write system calls, counted by wrapping fs
+let writeCalls = 0;
+const fsWrite = fs.write;
+const fsWritev = fs.writev;
+Object.assign(fs, {
+    write: (...args: any[]) => {
+        writeCalls++;
+        return (fsWrite as any)(...args);
+    },
+    writev: (...args: any[]) => {
+        writeCalls++;
+        return (fsWritev as any)(...args);
+    },
+});
+
+function openPair(create: (fd: number) => Endpoint) {
+    // eslint-disable-next-line @typescript-eslint/no-var-requires
+    const pty = require('../../build/Release/pty.node');
+    const handles = pty.create_pty() as PtyHandles;
+    return {
+        master: create(handles.master_fd),
+        slave: create(fs.openSync(handles.slave_name, 'r+')),
+    };
+}
+
+/** Write the commands in one burst and wait for them at the other end */
+function echo(
+    commands: Buffer[],
+    bytes: number,
+    master: Endpoint,
+    slave: Endpoint
+) {
+    return new Promise<void>((resolve) => {
+        let received = 0;
+        const onData = (data: Buffer) => {
+            received += data.length;
+            if (received >= bytes) {
+                slave.reader.off('data', onData);
+                resolve();
+            }
+        };
+        slave.reader.on('data', onData);
+        commands.forEach((command) => master.writer.write(command));
+    });
+}
+
+async function run(name: string, create: (fd: number) => Endpoint) {
+    const { master, slave } = openPair(create);
+    for (const count of [10, 100, 1000]) {
+        const commands: Buffer[] = [];
+        for (let i = 0; i < count; i++) {
+            commands.push(
+                Buffer.from(`${i}-var-update --all-values var${i}.child\n`)
+            );
+        }
+        const bytes = commands.reduce((sum, { length }) => sum + length, 0);
+        const allocations = slave.allocations;
+        const writes = writeCalls;
+        const iterations = 20;
+        const warmup = 2;
+        await bench(
+            `${name} ${count} commands (${formatBytes(bytes)})`,
+            () => echo(commands, bytes, master, slave),
+            { iterations, warmup, bytes }
+        );
+        const runs = iterations + warmup;
+        console.log(
+            `    ${((slave.allocations - allocations) / runs).toFixed(1)} ` +
+                `read buffers, ${((writeCalls - writes) / runs).toFixed(1)} ` +
+                'write calls per burst'
+        );
+    }
+}
+
+async function main() {
+    await run('File', (fd) => new File(fd));
+    await run('legacy File', (fd) => new LegacyFile(fd));
+    // reads are still pending on the slaves
+    process.exit();
+}
+
+main().catch((err) => {
+    console.error(err);
+    process.exit(1);
+});
@@ -10,9 +10,84 @@
 
 import * as fs from 'fs';
 import { Duplex, Readable, Writable } from 'stream';
+import { BufferPool } from './buffer-pool';
+
+/**
+ * Reads a file descriptor natively and passes what it reads to the
+ * callback, with a null chunk at the end.
+ */
+export interface NativeReader {
+    pause(): void;
+    resume(): void;
+    stop(): void;
+    /** Call back once the file descriptor can be written again */
+    waitWritable(callback: () => void): void;
+}
+
+export type NativeReaderFactory = (
+    fd: number,
+    onData: (err: Error | null, chunk: Buffer | null) => void
+) => NativeReader;
+
+// most iovecs a writev takes on Linux and macOS
+const IOV_MAX = 1024;
+
+/**
+ * Write all of buffers, in as few writev calls as possible.
+ *
+ * @param waitWritable calls back once a non-blocking fd that refused a
+ * write has room again, and returns false if it cannot tell
+ */
+export function writeAll(
+    fd: number,
+    buffers: Buffer[],
+    callback: (err: Error | null) => void,
+    waitWritable?: (callback: () => void) => boolean
+) {
+    const batch = buffers.slice(0, IOV_MAX);
+    fs.writev(fd, batch, (err, written) => {
+        if (
+            err &&
+            err.code === 'EAGAIN' &&
+            // a non-blocking terminal is full, wait for it to drain
+            waitWritable?.(() => writeAll(fd, buffers, callback, waitWritable))
+        ) {
+            return;
+        }
+        if (err) {
+            return callback(err);
+        }
+        const rest = buffers.slice(batch.length);
+        // short write: what is left of the batch goes first
+        let index = 0;
+        while (index < batch.length && written >= batch[index].length) {
+            written -= batch[index].length;
+            index++;
+        }
+        if (index < batch.length) {
+            rest.unshift(
+                batch[index].subarray(written),
+                ...batch.slice(index + 1)
+            );
+        }
+        if (rest.length) {
+            writeAll(fd, rest, callback, waitWritable);
+        } else {
+            callback(null);
+        }
+    });
+}
 
 export class File {
     protected _duplex: Duplex;
+    protected _nativeReader?: NativeReader;
+    protected _nativeReaderEnded = false;
+    protected _pool = new BufferPool();
+
+    /** Read buffers allocated so far */
+    get allocations(): number {
+        return this._pool.slabs;
+    }
 
     get reader(): Readable {
         return this._duplex;
@@ -22,23 +97,49 @@ export class File {
         return this._duplex;
     }
 
-    constructor(public fd: number) {
+    /**
+     * @param createReader reads fd natively instead of with fs.read,
+     * which holds a thread of the libuv pool while waiting for data.
+     */
+    constructor(
+        public fd: number,
+        protected createReader?: NativeReaderFactory
+    ) {
         // eslint-disable-next-line @typescript-eslint/no-this-alias
         const _this = this;
+        // the native reader also tells when a full fd has room again
+        const waitWritable = createReader
+            ? (callback: () => void) => {
+                  if (!_this._nativeReader && !_this._nativeReaderEnded) {
+                      _this.startNativeReader();
+                  }
+                  _this._nativeReader?.waitWritable(callback);
+                  return _this._nativeReader !== undefined;
+              }
+            : undefined;
         this._duplex = new Duplex({
             read(size) {
+                if (createReader) {
+                    if (_this._nativeReader) {
+                        _this._nativeReader.resume();
+                    } else {
+                        _this.startNativeReader();
+                    }
+                    return;
+                }
+                const room = _this._pool.reserve(size);
                 fs.read(
                     fd,
-                    Buffer.alloc(size),
+                    room,
                     0,
-                    size,
+                    room.length,
                     null,
                     (err, bytesRead, buffer) => {
                         if (err) {
                             console.error(fd, err.message);
                             this.push(null);
                         } else {
-                            this.push(buffer.slice(0, bytesRead));
+                            this.push(_this._pool.commit(buffer, bytesRead));
                         }
                     }
                 );
@@ -47,11 +148,24 @@ export class File {
                 const buffer = Buffer.isBuffer(chunk)
                     ? chunk
                     : Buffer.from(chunk, encoding);
-                fs.write(fd, buffer, (err, _written, _buffer) => {
-                    callback(err);
-                });
+                writeAll(fd, [buffer], callback, waitWritable);
+            },
+            // the chunks written while a write is pending, such as the MI
+            // commands of a pipeline, go out in one system call
+            writev(chunks, callback) {
+                writeAll(
+                    fd,
+                    chunks.map(({ chunk, encoding }) =>
+                        Buffer.isBuffer(chunk)
+                            ? chunk
+                            : Buffer.from(chunk, encoding)
+                    ),
+                    callback,
+                    waitWritable
+                );
             },
             destroy(err, callback) {
+                _this.stopNativeReader();
                 fs.close(fd, callback);
                 _this.fd = -1;
             },
@@ -61,4 +175,27 @@ export class File {
     destroy() {
         this._duplex.destroy();
     }
+
+    protected startNativeReader() {
+        const duplex = this._duplex;
+        const onData = (err: Error | null, chunk: Buffer | null) => {
+            if (err) {
+                console.error(this.fd, err.message);
+            }
+            if (err || !chunk) {
+                this._nativeReaderEnded = true;
+                this.stopNativeReader();
+                duplex.push(null);
+            } else if (!duplex.push(chunk)) {
+                this._nativeReader?.pause();
+            }
+        };
+        this._nativeReader = this.createReader?.(this.fd, onData);
+    }
+
+    protected stopNativeReader() {
+        const reader = this._nativeReader;
+        this._nativeReader = undefined;
+        reader?.stop();
+    }
 }
@@ -0,0 +1,79 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/**
+ * A GDB/MI record as decoded by the native parser.
+ *
+ * `type` is the record's prefix character. Result and async records
+ * ('^', '*', '=' and '+') carry `recordClass` and `data`, stream records
+ * ('~', '@' and '&') carry `text`, and the prompt is reported as '('.
+ */
+export interface NativeMIRecord {
+    token: string;
+    type: string;
+    recordClass?: string;
+    data?: any;
+    text?: string | null;
+}
+
+export interface NativeMIParser {
+    /**
+     * Decode one line of MI output (without the line terminator).
+     *
+     * Returns undefined for lines that are not MI records, the caller is
+     * expected to handle those itself.
+     */
+    parse_record(line: Buffer): NativeMIRecord | undefined;
+
+    /**
+     * Decode the hex digits of src between start and end.
+     *
+     * Returns undefined if they are not an even number of hex digits.
+     */
+    hex_to_bytes?(
+        src: Buffer,
+        start: number,
+        end: number
+    ): Buffer | undefined;
+
+    /**
+     * Convert hex digits to base64 in one pass.
+     *
+     * Returns undefined if hex is not an even number of hex digits.
+     */
+    hex_to_base64?(hex: string): string | undefined;
+
+    /**
+     * Convert base64 to hex digits in one pass.
+     *
+     * Returns undefined if base64 is not the canonical base64 of some
+     * bytes, missing padding aside. Empty base64 gives empty hex.
+     */
+    base64_to_hex?(base64: string): string | undefined;
+}
+
+let nativeParser: NativeMIParser | undefined | null = null;
+
+/**
+ * Load the native MI parser, if it was built for this platform.
+ *
+ * @returns the native module, or undefined if it is not available.
+ */
+export function loadNativeMIParser(): NativeMIParser | undefined {
+    if (nativeParser === null) {
+        try {
+            // eslint-disable-next-line @typescript-eslint/no-var-requires
+            nativeParser = require('../../build/Release/mi_parser.node');
+        } catch (err) {
+            nativeParser = undefined;
+        }
+    }
+    return nativeParser as NativeMIParser | undefined;
+}
@@ -0,0 +1,462 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+#include "napi.h"
+
+#include "codec.h"
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+/**
+ * Check that `data` is well-formed UTF-8, with the same strictness as the
+ * fatal TextDecoder used by the TypeScript parser (no overlongs, no
+ * surrogates, nothing above U+10FFFF).
+ */
+static bool is_valid_utf8(const unsigned char *data, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    unsigned char c = data[i];
+    if (c < 0x80) {
+      i++;
+      continue;
+    }
+    size_t extra;
+    unsigned int code_point;
+    unsigned int min;
+    if ((c & 0xE0) == 0xC0) {
+      extra = 1;
+      code_point = c & 0x1F;
+      min = 0x80;
+    } else if ((c & 0xF0) == 0xE0) {
+      extra = 2;
+      code_point = c & 0x0F;
+      min = 0x800;
+    } else if ((c & 0xF8) == 0xF0) {
+      extra = 3;
+      code_point = c & 0x07;
+      min = 0x10000;
+    } else {
+      return false;
+    }
+    if (i + extra >= len) {
+      return false;
+    }
+    for (size_t j = 1; j <= extra; j++) {
+      unsigned char cc = data[i + j];
+      if ((cc & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (cc & 0x3F);
+    }
+    if (code_point < min || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return false;
+    }
+    i += extra + 1;
+  }
+  return true;
+}
+
+/**
+ * Decodes one line of GDB/MI output.
+ *
+ * This is a byte-level port of MIParser.ts and deliberately keeps all of its
+ * quirks (peek/next/back semantics, weird array elements, values-only tuples,
+ * multiple results with the same name...) so that both parsers produce
+ * identical objects. The only differences are in places where the TypeScript
+ * parser never terminates on truncated input.
+ */
+class MIRecordParser {
+public:
+  MIRecordParser(Napi::Env env, const char *data, size_t len)
+      : m_env(env), m_data(data), m_len(len), m_pos(0) {}
+
+  /**
+   * Returns an object describing the record, or undefined when the line is
+   * not an MI record that this parser handles (e.g. inferior output on
+   * Windows) and the caller should fall back to the TypeScript parser.
+   */
+  Napi::Value parse_record() {
+    int c = next();
+    if (c < 0) {
+      return m_env.Undefined();
+    }
+
+    std::string token;
+    if (c >= '0' && c <= '9') {
+      token = handle_token();
+      c = next();
+    }
+
+    Napi::Object record = Napi::Object::New(m_env);
+    record.Set("token", token);
+    switch (c) {
+    case '^':
+    case '*':
+    case '=':
+    case '+': {
+      record.Set("type", std::string(1, static_cast<char>(c)));
+      record.Set("recordClass", handle_string());
+      record.Set("data", handle_async_data());
+      return record;
+    }
+    case '~':
+    case '@':
+    case '&':
+      record.Set("type", std::string(1, static_cast<char>(c)));
+      record.Set("text", handle_cstring());
+      return record;
+    case '(':
+      record.Set("type", "(");
+      return record;
+    default:
+      return m_env.Undefined();
+    }
+  }
+
+private:
+  int peek() const {
+    return m_pos < static_cast<ptrdiff_t>(m_len)
+               ? static_cast<unsigned char>(m_data[m_pos])
+               : -1;
+  }
+
+  int next() {
+    return m_pos < static_cast<ptrdiff_t>(m_len)
+               ? static_cast<unsigned char>(m_data[m_pos++])
+               : -1;
+  }
+
+  void back() { m_pos--; }
+
+  bool at_end() const { return m_pos >= static_cast<ptrdiff_t>(m_len); }
+
+  std::string handle_token() {
+    // the first digit has already been consumed
+    size_t start = m_pos - 1;
+    int c = next();
+    while (c >= '0' && c <= '9') {
+      c = next();
+    }
+    back();
+    return std::string(m_data + start, m_pos - start);
+  }
+
+  Napi::Value handle_cstring() {
+    std::string bytes;
+    bool escaped;
+    if (!read_cstring(bytes, escaped)) {
+      return m_env.Null();
+    }
+    return make_string(bytes, escaped);
+  }
+
+  /**
+   * Unescape a C string into `bytes`. Runs of plain characters are located
+   * with memchr and copied in one go. Returns false if there is no opening
+   * quote (which is consumed anyway, as in the TypeScript parser).
+   */
+  bool read_cstring(std::string &bytes, bool &escaped) {
+    escaped = false;
+    if (next() != '"') {
+      return false;
+    }
+
+    const char *end = m_data + m_len;
+    // Position of the next double quote, cached so that strings with many
+    // escapes are not rescanned from every backslash.
+    const char *quote = nullptr;
+    while (!at_end()) {
+      const char *start = m_data + m_pos;
+      if (quote < start) {
+        quote = static_cast<const char *>(memchr(start, '"', end - start));
+        if (!quote) {
+          quote = end;
+        }
+      }
+      const char *backslash =
+          static_cast<const char *>(memchr(start, '\\', quote - start));
+      const char *stop = backslash ? backslash : quote;
+      bytes.append(start, stop - start);
+      m_pos = stop - m_data;
+      if (stop == end) {
+        break;
+      }
+      next();
+      if (!backslash) {
+        // closing quote
+        break;
+      }
+      escaped = true;
+      int c = next();
+      if (c < 0) {
+        // The TypeScript parser loops forever on a trailing backslash
+        break;
+      }
+      switch (c) {
+      case 'n':
+        bytes.push_back('\n');
+        break;
+      case 't':
+        bytes.push_back('\t');
+        break;
+      case 'r':
+        break;
+      case '0':
+      case '1':
+      case '2':
+      case '3':
+      case '4':
+      case '5':
+      case '6':
+      case '7': {
+        // Like parseInt(octal, 8): the next two characters are always
+        // consumed, only the leading octal digits count.
+        if (m_pos + 2 > static_cast<ptrdiff_t>(m_len)) {
+          m_pos = m_len;
+          break;
+        }
+        unsigned int value = c - '0';
+        bool digits = true;
+        for (int i = 0; i < 2; i++) {
+          int d = next();
+          if (digits && d >= '0' && d <= '7') {
+            value = value * 8 + (d - '0');
+          } else {
+            digits = false;
+          }
+        }
+        bytes.push_back(static_cast<char>(value & 0xFF));
+        break;
+      }
+      default:
+        bytes.push_back(static_cast<char>(c));
+      }
+    }
+    return true;
+  }
+
+  Napi::Value make_string(const std::string &bytes, bool escaped) {
+    const unsigned char *raw =
+        reinterpret_cast<const unsigned char *>(bytes.data());
+    if (!escaped || is_valid_utf8(raw, bytes.size())) {
+      return Napi::String::New(m_env, bytes);
+    }
+    // Not UTF-8, return the bytes as code points like the TypeScript parser.
+    return Napi::String::New(m_env, std::u16string(raw, raw + bytes.size()));
+  }
+
+  std::string handle_string() {
+    size_t start = m_pos;
+    while (!at_end()) {
+      char c = m_data[m_pos];
+      if (c == '=' || c == ',') {
+        break;
+      }
+      m_pos++;
+    }
+    return std::string(m_data + start, m_pos - start);
+  }
+
+  Napi::Value handle_object() {
+    int c = next();
+    Napi::Object result = Napi::Object::New(m_env);
+    if (c == '{') {
+      c = next();
+      if (c != '"') {
+        // oject contains name-value pairs
+        while (c != '}' && c >= 0) {
+          if (c != ',') {
+            back();
+          }
+          std::string name = handle_string();
+          if (next() == '=') {
+            result.Set(name, handle_value());
+          }
+          c = next();
+        }
+      } else {
+        // "object" contains just values
+        back();
+        uint32_t key = 0;
+        std::string bytes;
+        bool escaped;
+        while (c != '}' && c >= 0) {
+          bytes.clear();
+          if (read_cstring(bytes, escaped) && !bytes.empty()) {
+            result.Set(key++, make_string(bytes, escaped));
+          }
+          c = next();
+        }
+      }
+    }
+
+    if (c == '}') {
+      return result;
+    }
+    return m_env.Null();
+  }
+
+  Napi::Value handle_array() {
+    int c = next();
+    Napi::Array result = Napi::Array::New(m_env);
+    uint32_t length = 0;
+    if (c == '[') {
+      c = next();
+      while (c != ']' && c >= 0) {
+        if (c != ',') {
+          back();
+        }
+        result.Set(length++, handle_value());
+        c = next();
+      }
+    }
+
+    if (c == ']') {
+      return result;
+    }
+    return m_env.Null();
+  }
+
+  Napi::Value handle_value() {
+    int c = peek();
+    switch (c) {
+    case '"':
+      return handle_cstring();
+    case '{':
+      return handle_object();
+    case '[':
+      return handle_array();
+    default:
+      // A weird array element with a name, ignore the name and return the
+      // value
+      handle_string();
+      if (next() == '=') {
+        return handle_value();
+      }
+    }
+    return m_env.Null();
+  }
+
+  Napi::Value handle_async_data() {
+    Napi::Object result = Napi::Object::New(m_env);
+
+    int c = next();
+    std::string name = "missing";
+    while (c == ',') {
+      if (peek() != '{') {
+        name = handle_string();
+        if (next() == '=') {
+          result.Set(name, handle_value());
+        }
+      } else {
+        // Multiple results with the same name, see MIParser.handleAsyncData
+        Napi::Value previous = result.Get(name);
+        Napi::Array array;
+        if (previous.IsArray()) {
+          array = previous.As<Napi::Array>();
+        } else {
+          array = Napi::Array::New(m_env);
+          array.Set(0u, previous);
+          result.Set(name, array);
+        }
+        array.Set(array.Length(), handle_value());
+      }
+      c = next();
+    }
+
+    return result;
+  }
+
+  Napi::Env m_env;
+  const char *m_data;
+  size_t m_len;
+  ptrdiff_t m_pos;
+};
+
+static Napi::Value parse_record(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsBuffer()) {
+    throw Napi::TypeError::New(env, "parse_record: expected a Buffer");
+  }
+  Napi::Buffer<char> line = info[0].As<Napi::Buffer<char>>();
+  MIRecordParser parser(env, line.Data(), line.Length());
+  return parser.parse_record();
+}
+
+/**
+ * hex_to_bytes(buffer, start, end): decode the hex digits of the buffer
+ * between start and end, or return undefined if they are not hex digits.
+ */
+static Napi::Value hex_to_bytes(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 3 || !info[0].IsBuffer() || !info[1].IsNumber() ||
+      !info[2].IsNumber()) {
+    throw Napi::TypeError::New(env,
+                               "hex_to_bytes: expected (Buffer, start, end)");
+  }
+  Napi::Buffer<char> src = info[0].As<Napi::Buffer<char>>();
+  int64_t start = info[1].As<Napi::Number>().Int64Value();
+  int64_t end = info[2].As<Napi::Number>().Int64Value();
+  if (start < 0 || end < start || static_cast<size_t>(end) > src.Length() ||
+      (end - start) % 2) {
+    return env.Undefined();
+  }
+  Napi::Buffer<uint8_t> bytes =
+      Napi::Buffer<uint8_t>::New(env, (end - start) / 2);
+  if (!codec::decode_hex(src.Data() + start, end - start, bytes.Data())) {
+    return env.Undefined();
+  }
+  return bytes;
+}
+
+/**
+ * hex_to_base64(hex): the base64 of the bytes of the hex string, or
+ * undefined if it is not an even number of hex digits.
+ */
+static Napi::Value hex_to_base64(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    throw Napi::TypeError::New(env, "hex_to_base64: expected a string");
+  }
+  std::string hex = info[0].As<Napi::String>().Utf8Value();
+  std::string base64;
+  if (!codec::hex_to_base64(hex.data(), hex.size(), base64)) {
+    return env.Undefined();
+  }
+  return Napi::String::New(env, base64);
+}
+
+/**
+ * base64_to_hex(base64): the hex digits of the bytes of the base64 string,
+ * or undefined if it is not canonical base64.
+ */
+static Napi::Value base64_to_hex(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    throw Napi::TypeError::New(env, "base64_to_hex: expected a string");
+  }
+  std::string base64 = info[0].As<Napi::String>().Utf8Value();
+  std::string hex;
+  if (!codec::base64_to_hex(base64.data(), base64.size(), hex)) {
+    return env.Undefined();
+  }
+  return Napi::String::New(env, hex);
+}
+
+static Napi::Object initialize(Napi::Env env, Napi::Object exports) {
+  exports.Set("parse_record", Napi::Function::New(env, parse_record));
+  exports.Set("hex_to_bytes", Napi::Function::New(env, hex_to_bytes));
+  exports.Set("hex_to_base64", Napi::Function::New(env, hex_to_base64));
+  exports.Set("base64_to_hex", Napi::Function::New(env, base64_to_hex));
+  return exports;
+}
+
+NODE_API_MODULE(NODE_GYP_MODULE_NAME, initialize);
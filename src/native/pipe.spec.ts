@@ -0,0 +1,73 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+import { expect } from 'chai';
+import { spawn } from 'child_process';
+import { ChildPipes } from '../native/pipe';
+
+if (process.platform === 'linux') {
+    describe('child pipes', function () {
+        let pipes: ChildPipes | undefined;
+
+        afterEach(function () {
+            pipes?.destroy();
+            pipes = undefined;
+        });
+
+        it('should let the child write the whole size without a reader', async function () {
+            const size = 1024 * 1024;
+            pipes = new ChildPipes(size);
+            expect(pipes.size).gte(size);
+            // the child reports on stderr once everything is in the pipe,
+            // which 64 KB socket buffers would not hold
+            const child = spawn(
+                'sh',
+                ['-c', `head -c ${size} /dev/zero && echo done >&2`],
+                { stdio: [pipes.stdio[0], pipes.stdio[1], 'pipe'] }
+            );
+            pipes.closeChildEnds();
+            await new Promise<void>((resolve) =>
+                child.stderr?.on('data', (data: Buffer) => {
+                    if (data.toString().includes('done')) {
+                        resolve();
+                    }
+                })
+            );
+            let received = 0;
+            pipes.stdout.reader.on('data', (data: Buffer) => {
+                received += data.length;
+            });
+            await new Promise((resolve) =>
+                pipes?.stdout.reader.once('end', resolve)
+            );
+            expect(received).eq(size);
+        });
+
+        it('should pass what is written to the stdin of the child', async function () {
+            pipes = new ChildPipes(1024 * 1024);
+            spawn('cat', [], {
+                stdio: [pipes.stdio[0], pipes.stdio[1], 'pipe'],
+            });
+            pipes.closeChildEnds();
+            let output = '';
+            pipes.stdout.reader.on('data', (data: Buffer) => {
+                output += data.toString();
+            });
+            const ended = new Promise((resolve) =>
+                pipes?.stdout.reader.once('end', resolve)
+            );
+            pipes.stdin.writer.write('-gdb-version\n');
+            // cat exits once stdin is closed
+            pipes.stdin.destroy();
+            await ended;
+            expect(output).eq('-gdb-version\n');
+        });
+    });
+}
@@ -0,0 +1,98 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+import * as fs from 'fs';
+import { File, NativeReaderFactory } from './file';
+import { nativeReader } from './pty';
+
+interface PipeHandles {
+    read_fd: number;
+    write_fd: number;
+    size: number;
+}
+
+/**
+ * A native reader that only waits for room to write, for the write end of
+ * a pipe, which cannot be read.
+ */
+function writeOnly(
+    createReader?: NativeReaderFactory
+): NativeReaderFactory | undefined {
+    return (
+        createReader &&
+        ((fd, onData) => {
+            const reader = createReader(fd, onData);
+            reader.pause();
+            return reader;
+        })
+    );
+}
+
+/**
+ * The stdin and stdout of a child process as pipes of a given size.
+ *
+ * Node gives child processes socketpairs, which cannot be resized, so the
+ * pipes are created by the pty addon and passed to spawn as file
+ * descriptors. Linux only, limited to /proc/sys/fs/pipe-max-size for
+ * unprivileged users.
+ */
+export class ChildPipes {
+    /** The ends to spawn the child with, as its stdin and stdout */
+    public readonly stdio: [number, number];
+    /** Writes to the stdin of the child */
+    public readonly stdin: File;
+    /** Reads the stdout of the child */
+    public readonly stdout: File;
+    /** The size of each pipe in bytes */
+    public readonly size: number;
+
+    /**
+     * @throws if the pipes could not be created or resized
+     */
+    constructor(size: number) {
+        if (process.platform !== 'linux') {
+            throw new Error('Pipes can only be resized on Linux');
+        }
+        // eslint-disable-next-line @typescript-eslint/no-var-requires
+        const pty = require('../../build/Release/pty.node');
+        const input = pty.create_pipe(size, false) as PipeHandles;
+        let output: PipeHandles;
+        try {
+            output = pty.create_pipe(size, true) as PipeHandles;
+        } catch (err) {
+            fs.closeSync(input.read_fd);
+            fs.closeSync(input.write_fd);
+            throw err;
+        }
+        this.stdio = [input.read_fd, output.write_fd];
+        this.stdin = new File(input.write_fd, writeOnly(nativeReader(pty)));
+        this.stdout = new File(output.read_fd, nativeReader(pty));
+        this.size = Math.min(input.size, output.size);
+    }
+
+    /**
+     * Close the ends of the child in this process, once it is spawned
+     * with its own copies, so that its exit ends the output.
+     */
+    closeChildEnds() {
+        for (const fd of this.stdio) {
+            if (fd >= 0) {
+                fs.closeSync(fd);
+            }
+        }
+        this.stdio[0] = this.stdio[1] = -1;
+    }
+
+    destroy() {
+        this.closeChildEnds();
+        this.stdin.destroy();
+        this.stdout.destroy();
+    }
+}
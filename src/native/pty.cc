@@ -11,10 +11,18 @@
 
 #ifdef LINUX
 #include "scoped_fd.h"
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
 #include <fcntl.h>
+#include <poll.h>
 #include <termios.h>
 
 /**
@@ -39,6 +47,291 @@ static void _throw_exc_format(const Napi::Env env, int error,
 #endif // _GNU_SOURCE
   throw Napi::Error::New(env, message);
 }
+
+/**
+ * What the reader thread hands to JS: output it read, or the end of the
+ * output when data is null, with the errno of the failed read if any.
+ */
+struct read_chunk {
+  char *data;
+  size_t length;
+  int error;
+};
+
+/**
+ * Lock-free ring of chunks from a single producer thread to a single
+ * consumer thread.
+ */
+template <size_t N> class spsc_ring {
+public:
+  bool full() const {
+    return (m_head.load(std::memory_order_relaxed) + 1) % N ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  bool push(const read_chunk &chunk) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t next = (head + 1) % N;
+    if (next == m_tail.load(std::memory_order_acquire))
+      return false;
+    m_slots[head] = chunk;
+    m_head.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(read_chunk &chunk) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail == m_head.load(std::memory_order_acquire))
+      return false;
+    chunk = m_slots[tail];
+    m_tail.store((tail + 1) % N, std::memory_order_release);
+    return true;
+  }
+
+private:
+  read_chunk m_slots[N];
+  std::atomic<size_t> m_head{0};
+  std::atomic<size_t> m_tail{0};
+};
+
+/**
+ * Reads a file descriptor on its own thread, so that reading the pty does
+ * not hold a libuv thread pool worker.
+ *
+ * The thread copies what it reads into buffers of the exact size and
+ * queues them in a ring. JS is woken once for everything queued since its
+ * last wake up, and gets the buffers without another copy. The thread
+ * stops reading while JS is paused or the ring is full.
+ *
+ * The thread also polls for room to write when JS asks, so that writes
+ * the non-blocking fd refuses are retried as soon as they can succeed.
+ *
+ * new PtyReader(fd, (error, chunk) => ...): chunk is null at the end.
+ * reader.waitWritable(callback): calls back once fd can be written.
+ */
+class PtyReader : public Napi::ObjectWrap<PtyReader> {
+public:
+  static Napi::Function define(Napi::Env env) {
+    return DefineClass(env, "PtyReader",
+                       {InstanceMethod("pause", &PtyReader::pause),
+                        InstanceMethod("resume", &PtyReader::resume),
+                        InstanceMethod("stop", &PtyReader::stop),
+                        InstanceMethod("waitWritable",
+                                       &PtyReader::wait_writable)});
+  }
+
+  PtyReader(const Napi::CallbackInfo &info)
+      : Napi::ObjectWrap<PtyReader>(info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsFunction())
+      throw Napi::TypeError::New(env, "PtyReader(fd, callback)");
+    m_fd = info[0].As<Napi::Number>().Int32Value();
+    if (pipe2(m_wake, O_CLOEXEC | O_NONBLOCK))
+      _throw_exc_format(env, errno, "pipe2");
+    // stay alive until the thread safe function is done with this
+    Ref();
+    m_tsfn = Napi::ThreadSafeFunction::New(
+        env, info[1].As<Napi::Function>(), "PtyReader", 0, 1,
+        [this](Napi::Env) { Unref(); });
+    m_thread = std::thread(&PtyReader::run, this);
+  }
+
+  ~PtyReader() {
+    halt();
+    read_chunk chunk;
+    while (m_ring.pop(chunk))
+      free(chunk.data);
+  }
+
+private:
+  static const size_t READ_SIZE = 64 * 1024;
+
+  Napi::Value pause(const Napi::CallbackInfo &info) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_paused = true;
+    return info.Env().Undefined();
+  }
+
+  Napi::Value resume(const Napi::CallbackInfo &info) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_paused = false;
+    }
+    m_wakeup.notify_one();
+    return info.Env().Undefined();
+  }
+
+  Napi::Value stop(const Napi::CallbackInfo &info) {
+    halt();
+    return info.Env().Undefined();
+  }
+
+  Napi::Value wait_writable(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsFunction())
+      throw Napi::TypeError::New(env, "waitWritable(callback)");
+    if (!m_thread.joinable())
+      throw Napi::Error::New(env, "waitWritable: the reader is stopped");
+    m_onWritable = Napi::Persistent(info[0].As<Napi::Function>());
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_wantWritable = true;
+    }
+    m_wakeup.notify_one();
+    interrupt();
+    return env.Undefined();
+  }
+
+  /** Make the thread poll() again, with what it waits for now */
+  void interrupt() {
+    char byte = 0;
+    if (write(m_wake[1], &byte, 1) < 0) {
+      // the pipe is full, poll() returns anyway
+    }
+  }
+
+  /** Stop the thread and let go of the JS callback, once */
+  void halt() {
+    if (!m_thread.joinable())
+      return;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stopping = true;
+    }
+    m_wakeup.notify_one();
+    interrupt();
+    m_thread.join();
+    close(m_wake[0]);
+    close(m_wake[1]);
+    m_tsfn.Release();
+  }
+
+  /** The reader thread */
+  void run() {
+    char *scratch = static_cast<char *>(malloc(READ_SIZE));
+    read_chunk end = {nullptr, 0, 0};
+    for (;;) {
+      bool reading, writing;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wakeup.wait(lock, [this] {
+          return m_stopping || m_wantWritable ||
+                 (!m_paused && !m_ring.full());
+        });
+        if (m_stopping)
+          break;
+        reading = !m_paused && !m_ring.full();
+        writing = m_wantWritable;
+      }
+      short events = (reading ? POLLIN : 0) | (writing ? POLLOUT : 0);
+      pollfd fds[2] = {{m_fd, events, 0}, {m_wake[0], POLLIN, 0}};
+      if (poll(fds, 2, -1) < 0) {
+        if (errno == EINTR)
+          continue;
+        end.error = errno;
+        break;
+      }
+      if (fds[1].revents) {
+        char drain[16];
+        while (read(m_wake[0], drain, sizeof(drain)) > 0) {
+        }
+        continue;
+      }
+      if (writing && (fds[0].revents & (POLLOUT | POLLERR | POLLHUP))) {
+        // on errors too: the write JS retries then reports them
+        {
+          std::lock_guard<std::mutex> lock(m_mutex);
+          m_wantWritable = false;
+        }
+        m_writable.store(true);
+        notify();
+      }
+      if (!reading || !(fds[0].revents & ~POLLOUT))
+        continue;
+      ssize_t count = read(m_fd, scratch, READ_SIZE);
+      if (count < 0) {
+        if (errno == EINTR || errno == EAGAIN)
+          continue;
+        end.error = errno;
+        break;
+      }
+      if (count == 0)
+        break;
+      char *data = static_cast<char *>(malloc(count));
+      memcpy(data, scratch, count);
+      m_ring.push({data, static_cast<size_t>(count), 0});
+      notify();
+    }
+    free(scratch);
+    if (!m_stopping) {
+      // the ring may be full, wait for room for the end
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_wakeup.wait(lock, [this] { return m_stopping || !m_ring.full(); });
+      if (!m_stopping) {
+        m_ring.push(end);
+        lock.unlock();
+        notify();
+      }
+    }
+  }
+
+  /** Wake JS up, unless it already is for earlier chunks */
+  void notify() {
+    if (!m_notified.exchange(true))
+      m_tsfn.NonBlockingCall(
+          [this](Napi::Env env, Napi::Function callback) {
+            deliver(env, callback);
+          });
+  }
+
+  /** Pass the queued chunks to JS, on the JS thread */
+  void deliver(Napi::Env env, Napi::Function callback) {
+    // chunks pushed from now on need another wake up
+    m_notified.store(false);
+    if (m_writable.exchange(false) && !m_stopping) {
+      Napi::Function onWritable = m_onWritable.Value();
+      m_onWritable.Reset();
+      onWritable.Call(std::vector<napi_value>());
+    }
+    read_chunk chunk;
+    while (m_ring.pop(chunk)) {
+      if (m_stopping) {
+        free(chunk.data);
+      } else if (chunk.data) {
+        callback.Call(
+            {env.Null(), Napi::Buffer<char>::New(
+                             env, chunk.data, chunk.length,
+                             [](Napi::Env, char *data) { free(data); })});
+      } else if (chunk.error) {
+        callback.Call({Napi::Error::New(env, strerror(chunk.error)).Value(),
+                       env.Null()});
+      } else {
+        callback.Call({env.Null(), env.Null()});
+      }
+    }
+    // room in the ring for the thread
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_wakeup.notify_one();
+  }
+
+  int m_fd = -1;
+  // written to interrupt poll() when stopping
+  int m_wake[2] = {-1, -1};
+  std::thread m_thread;
+  Napi::ThreadSafeFunction m_tsfn;
+  spsc_ring<256> m_ring;
+  std::atomic<bool> m_notified{false};
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_paused = false;
+  std::atomic<bool> m_stopping{false};
+  // JS waits for room to write, m_writable tells it there is
+  bool m_wantWritable = false;
+  std::atomic<bool> m_writable{false};
+  Napi::FunctionReference m_onWritable;
+};
 #endif // LINUX
 
 static Napi::Value create_pty(const Napi::CallbackInfo &info) {
@@ -91,8 +384,79 @@ static Napi::Value create_pty(const Napi::CallbackInfo &info) {
 #endif
 }
 
+/**
+ * Open a terminal, such as the slave side of a pty, for a PtyReader to read
+ * it. The file is non-blocking so that opening it cannot hang and that
+ * reading it never blocks the reader thread past a cancellation.
+ */
+static Napi::Value open_tty(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+#ifndef LINUX
+  throw Napi::Error::New(env, ".open_tty() is not supported on this platform");
+#else
+  if (info.Length() < 1 || !info[0].IsString())
+    throw Napi::TypeError::New(env, "open_tty(path)");
+  std::string path = info[0].As<Napi::String>().Utf8Value();
+  int fd = open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd == -1)
+    _throw_exc_format(env, errno, "open");
+  if (!isatty(fd)) {
+    close(fd);
+    _throw_exc_format(env, ENOTTY, "open_tty");
+  }
+  return Napi::Number::New(env, fd);
+#endif
+}
+
+/**
+ * Create a pipe for the stdin or stdout of a child process, of the given
+ * size, so that the child can write large records without waiting for
+ * this process to drain the pipe. Node gives children socketpairs, which
+ * cannot be resized. Both ends are close-on-exec so that other children
+ * do not keep the pipe open, and the end this process keeps is
+ * non-blocking, for a PtyReader. Returns the ends and the new size.
+ */
+static Napi::Value create_pipe(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+#ifndef LINUX
+  throw Napi::Error::New(env,
+                         ".create_pipe() is not supported on this platform");
+#else
+  if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsBoolean())
+    throw Napi::TypeError::New(env, "create_pipe(size, parent_reads)");
+  int size = info[0].As<Napi::Number>().Int32Value();
+  bool parent_reads = info[1].As<Napi::Boolean>().Value();
+  int fds[2];
+  if (pipe2(fds, O_CLOEXEC))
+    _throw_exc_format(env, errno, "pipe2");
+  // both ends are closed on scope exit if an error is thrown
+  scoped_fd read_fd(fds[0]);
+  scoped_fd write_fd(fds[1]);
+  if (fcntl(write_fd.get(), F_SETPIPE_SZ, size) == -1)
+    _throw_exc_format(env, errno, "fcntl(F_SETPIPE_SZ)");
+  int actual = fcntl(write_fd.get(), F_GETPIPE_SZ);
+  if (actual == -1)
+    _throw_exc_format(env, errno, "fcntl(F_GETPIPE_SZ)");
+  // the child's end stays blocking, as programs expect of their stdio
+  int parent_fd = parent_reads ? read_fd.get() : write_fd.get();
+  int flags = fcntl(parent_fd, F_GETFL);
+  if (flags == -1 || fcntl(parent_fd, F_SETFL, flags | O_NONBLOCK) == -1)
+    _throw_exc_format(env, errno, "fcntl(F_SETFL)");
+  Napi::Object pipe = Napi::Object::New(env);
+  pipe.Set("read_fd", read_fd.release());
+  pipe.Set("write_fd", write_fd.release());
+  pipe.Set("size", actual);
+  return pipe;
+#endif
+}
+
 static Napi::Object initialize(Napi::Env env, Napi::Object exports) {
   exports.Set("create_pty", Napi::Function::New(env, create_pty));
+  exports.Set("open_tty", Napi::Function::New(env, open_tty));
+  exports.Set("create_pipe", Napi::Function::New(env, create_pipe));
+#ifdef LINUX
+  exports.Set("PtyReader", PtyReader::define(env));
+#endif
   return exports;
 }
 
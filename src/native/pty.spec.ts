@@ -10,13 +10,12 @@
 
 import { expect } from 'chai';
 import { Readable, Writable } from 'stream';
-import { Pty } from '../native/pty';
-import { ForkedFile } from '../native/forked-file';
+import { Pty, Tty } from '../native/pty';
 
 if (process.platform !== 'win32') {
     describe('pty creation', function () {
         let master: Pty;
-        let slave: ForkedFile;
+        let slave: Tty;
 
         afterEach(function () {
             if (slave) {
@@ -31,7 +30,7 @@ if (process.platform !== 'win32') {
             'should be able to open a ptmx/pts pair',
             failFast(async function (fail) {
                 master = new Pty();
-                slave = new ForkedFile(master.slave_name);
+                slave = new Tty(master.slave_name);
 
                 let masterBuffer = '';
                 let slaveBuffer = '';
@@ -59,6 +58,42 @@ if (process.platform !== 'win32') {
                 expect(slaveBuffer).eq('master2slave');
             })
         );
+
+        it('should close the slave while it is being read', async function () {
+            master = new Pty();
+            slave = new Tty(master.slave_name);
+            const closed = new Promise((resolve) =>
+                slave.reader.once('close', resolve)
+            );
+            // a read is pending as long as data is expected
+            slave.reader.on('data', () => undefined);
+            slave.destroy();
+            await closed;
+            expect(slave.fd).eq(-1);
+        });
+
+        it('should write more than the terminal holds', async function () {
+            master = new Pty();
+            slave = new Tty(master.slave_name);
+            const payload = Buffer.alloc(1024 * 1024, 'x');
+            let received = 0;
+            const done = new Promise<void>((resolve) =>
+                master.reader.on('data', (data: Buffer) => {
+                    received += data.length;
+                    if (received >= payload.length) {
+                        resolve();
+                    }
+                })
+            );
+            // the slave is non-blocking, it refuses most of this at first
+            await new Promise<void>((resolve, reject) =>
+                slave.writer.write(payload, (err) =>
+                    err ? reject(err) : resolve()
+                )
+            );
+            await done;
+            expect(received).eq(payload.length);
+        });
     });
 }
 
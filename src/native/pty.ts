@@ -8,7 +8,7 @@
  * SPDX-License-Identifier: EPL-2.0
  *********************************************************************/
 
-import { File } from './file';
+import { File, NativeReaderFactory } from './file';
 export { File };
 
 interface PtyHandles {
@@ -16,6 +16,16 @@ interface PtyHandles {
     slave_name: string;
 }
 
+// eslint-disable-next-line @typescript-eslint/no-var-requires
+const loadAddon = () => require('../../build/Release/pty.node');
+
+export function nativeReader(pty: any): NativeReaderFactory | undefined {
+    // PtyReader only exists where the addon implements it
+    return pty.PtyReader
+        ? (fd, onData) => new pty.PtyReader(fd, onData)
+        : undefined;
+}
+
 /**
  * Represents the master-side of a pseudo-terminal master/slave pair.
  */
@@ -23,10 +33,23 @@ export class Pty extends File {
     public readonly slave_name: string;
 
     constructor() {
-        // eslint-disable-next-line @typescript-eslint/no-var-requires
-        const pty = require('../../build/Release/pty.node');
+        const pty = loadAddon();
         const handles = pty.create_pty() as PtyHandles;
-        super(handles.master_fd);
+        super(handles.master_fd, nativeReader(pty));
         this.slave_name = handles.slave_name;
     }
 }
+
+/**
+ * A terminal opened by path, such as the slave side of a Pty.
+ *
+ * It is read from a native thread which destroy() stops, so that it can be
+ * closed in this process even though the master side is open too: closing
+ * a terminal with a pending fs.read leaves node hanging at exit.
+ */
+export class Tty extends File {
+    constructor(public readonly path: string) {
+        const pty = loadAddon();
+        super(pty.open_tty(path) as number, nativeReader(pty));
+    }
+}
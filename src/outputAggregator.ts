@@ -0,0 +1,64 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+/**
+ * Merges consecutive stream outputs of the same category, so that commands
+ * producing thousands of lines of output don't send an event per line.
+ *
+ * Output is sent when the category changes, when `threshold` characters
+ * are buffered, at the end of the current event loop turn, or when flush
+ * is called. Callers must flush before sending anything that should be
+ * ordered after the output.
+ */
+export class OutputAggregator {
+    protected category?: string;
+    protected chunks: string[] = [];
+    protected length = 0;
+    protected immediate?: NodeJS.Immediate;
+
+    /**
+     * @param send called with the merged output
+     * @param threshold number of characters to buffer before sending the
+     * output, 0 to send each output right away
+     */
+    constructor(
+        protected send: (output: string, category: string) => void,
+        public threshold = 16 * 1024
+    ) {}
+
+    public append(output: string, category: string) {
+        if (category !== this.category) {
+            this.flush();
+            this.category = category;
+        }
+        this.chunks.push(output);
+        this.length += output.length;
+        if (this.length >= this.threshold) {
+            this.flush();
+        } else if (!this.immediate) {
+            this.immediate = setImmediate(() => this.flush());
+        }
+    }
+
+    public flush() {
+        if (this.immediate) {
+            clearImmediate(this.immediate);
+            this.immediate = undefined;
+        }
+        if (this.chunks.length === 0 || this.category === undefined) {
+            return;
+        }
+        const output =
+            this.chunks.length === 1 ? this.chunks[0] : this.chunks.join('');
+        this.chunks = [];
+        this.length = 0;
+        this.send(output, this.category);
+    }
+}
@@ -0,0 +1,148 @@
+/*********************************************************************
+ * Copyright (c) 2026 Ericsson and others
+ *
+ * This program and the accompanying materials are made
+ * available under the terms of the Eclipse Public License 2.0
+ * which is available at https://www.eclipse.org/legal/epl-2.0/
+ *
+ * SPDX-License-Identifier: EPL-2.0
+ *********************************************************************/
+
+import { RequestContext } from './commandScheduler';
+
+/**
+ * Commands without side effects, whose result only depends on the state
+ * of the target and of the selected thread and frame.
+ */
+const readOnlyCommands = new Set([
+    '-data-list-register-names',
+    '-data-list-register-values',
+    '-list-features',
+    '-list-target-features',
+    '-stack-info-depth',
+    '-stack-info-frame',
+    '-stack-list-arguments',
+    '-stack-list-frames',
+    '-stack-list-locals',
+    '-stack-list-variables',
+    '-thread-info',
+    '-thread-list-ids',
+]);
+
+export function isReadOnlyCommand(command: string) {
+    const end = command.indexOf(' ');
+    return readOnlyCommands.has(end === -1 ? command : command.slice(0, end));
+}
+
+/**
+ * The requests waiting for a shared command. It is only cancelled once
+ * all of them are, the others still need the result.
+ */
+export class SharedRequest implements RequestContext {
+    protected requests: RequestContext[];
+    // joined by a sender that was not handling a request
+    protected pinned = false;
+
+    constructor(request: RequestContext) {
+        this.requests = [request];
+    }
+
+    get seq() {
+        return this.requests[0].seq;
+    }
+
+    get cancelled() {
+        return (
+            !this.pinned &&
+            this.requests.every((request) => request.cancelled)
+        );
+    }
+
+    public serves(request: RequestContext) {
+        return this.requests.indexOf(request) !== -1;
+    }
+
+    public join(request: RequestContext | undefined) {
+        if (request) {
+            this.requests.push(request);
+        } else {
+            this.pinned = true;
+        }
+    }
+}
+
+interface Flight {
+    promise: Promise<any>;
+    /** Undefined when the first sender was not handling a request */
+    request?: SharedRequest;
+}
+
+/**
+ * Shares the result of read-only commands between identical commands
+ * sent while the first one is still waiting for its result.
+ *
+ * gdb runs commands in order, so a command can only join one that was
+ * sent after the last command that may have changed the state. The
+ * commands in flight are forgotten whenever another command is sent, and
+ * when the owner calls clear() because the target changed state.
+ */
+export class SingleFlight {
+    protected inFlight = new Map<string, Flight>();
+    protected hits = 0;
+    protected misses = 0;
+
+    /**
+     * Send command on behalf of request, or share the result of the same
+     * command in flight. A shared command is sent on behalf of all the
+     * requests that wait for it, so that it is only dropped if they are
+     * all cancelled.
+     */
+    public run<T>(
+        command: string,
+        options: object | undefined,
+        send: (request?: RequestContext) => Promise<T>,
+        request?: RequestContext
+    ): Promise<T> {
+        if (!isReadOnlyCommand(command)) {
+            this.clear();
+            return send(request);
+        }
+        const key = options ? `${command} ${JSON.stringify(options)}` : command;
+        const shared = this.inFlight.get(key);
+        if (shared) {
+            this.hits++;
+            shared.request?.join(request);
+            return shared.promise;
+        }
+        this.misses++;
+        const flight: Flight = {
+            promise: Promise.resolve(),
+            request: request && new SharedRequest(request),
+        };
+        const promise = send(flight.request);
+        flight.promise = promise;
+        this.inFlight.set(key, flight);
+        const done = () => {
+            if (this.inFlight.get(key) === flight) {
+                this.inFlight.delete(key);
+            }
+        };
+        promise.then(done, done);
+        return promise;
+    }
+
+    public clear() {
+        this.inFlight.clear();
+    }
+
+    /** Read-only commands that shared the result of another one */
+    get shared() {
+        return this.hits;
+    }
+
+    /** The proportion of read-only commands that were shared */
+    get hitRate() {
+        const total = this.hits + this.misses;
+        return total ? this.hits / total : 0;
+    }
+}
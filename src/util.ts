@@ -12,22 +12,29 @@ import { platform } from 'os';
 import { promisify } from 'util';
 import { dirname } from 'path';
 import { existsSync } from 'fs';
+import { GdbProbeCache } from './gdbProbeCache';
 
 /**
  * This method actually launches 'gdb --version' to determine the version of
- * the GDB that is being used.
+ * the GDB that is being used, unless it is in the probe cache.
  *
  * @param gdbPath the path to the GDB executable to be called
+ * @param cache where the version is looked up and saved, if any
  * @return the detected version of GDB at gdbPath
  */
 export async function getGdbVersion(
     gdbPath: string,
     gdbCwd?: string,
-    environment?: Record<string, string | null>
+    environment?: Record<string, string | null>,
+    cache?: GdbProbeCache
 ): Promise<string> {
     const gdbEnvironment = environment
         ? createEnvValues(process.env, environment)
         : process.env;
+    const probe = await cache?.lookup(gdbPath, gdbCwd, gdbEnvironment);
+    if (probe?.version) {
+        return probe.version;
+    }
     const { stdout, stderr } = await promisify(execFile)(
         gdbPath,
         ['--version'],
@@ -40,6 +47,9 @@ export async function getGdbVersion(
             `Failed to get version number from GDB. GDB returned:\nstdout:\n${stdout}\nstderr:\n${stderr}`
         );
     }
+    await cache?.store(gdbPath, gdbCwd, gdbEnvironment, {
+        version: gdbVersion,
+    });
     return gdbVersion;
 }
 
@@ -180,3 +190,13 @@ export function getGdbCwd(launchArgs: {
             : process.cwd());
     return existsSync(cwd) ? cwd : process.cwd();
 }
+
+/**
+ * The start of input, for error messages about inputs that can be
+ * megabytes long.
+ */
+export function excerpt(input: string, length = 32): string {
+    return input.length <= length
+        ? input
+        : `${input.slice(0, length)}... (${input.length} characters)`;
+}
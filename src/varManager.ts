@@ -1,5 +1,6 @@
+import { logger } from '@vscode/debugadapter/lib/logger';
 import { GDBBackend } from './GDBBackend';
-import { MIVarCreateResponse } from './mi/var';
+import { MIVarCreateResponse, MIVarUpdateResponse } from './mi/var';
 import { sendVarCreate, sendVarDelete, sendVarUpdate } from './mi/var';
 
 export interface VarObjType {
@@ -12,85 +13,184 @@ export interface VarObjType {
     isVar: boolean;
     isChild: boolean;
     varType: string;
+    /** gdb reported the varobj out of scope at the last update */
+    outOfScope?: boolean;
 }
 
+/**
+ * Commands that can run the program or write its memory or registers,
+ * besides the -exec- and -target- ones. The console commands of
+ * -interpreter-exec can do anything, -gdb-set var assigns variables.
+ */
+const changeValuesCommands = new Set([
+    '-data-write-memory',
+    '-data-write-memory-bytes',
+    '-data-write-register-values',
+    '-gdb-set',
+    '-interpreter-exec',
+    '-var-assign',
+]);
+
+/** Commands that evaluate an expression, which may have side effects */
+const evaluateCommands = new Set(['-data-evaluate-expression', '-var-create']);
+
+// assignments, increments, decrements and function calls
+const sideEffectRegex = /(?:^|[^=!<>])=(?!=)|<<=|>>=|\+\+|--|[\w$]\s*\(/;
+
+/** Whether the values of the varobjs may have changed after command */
+export function mayChangeValues(command: string) {
+    if (!command.startsWith('-')) {
+        // a CLI command
+        return true;
+    }
+    const end = command.indexOf(' ');
+    const name = end === -1 ? command : command.slice(0, end);
+    if (name.startsWith('-exec-') || name.startsWith('-target-')) {
+        return true;
+    }
+    if (evaluateCommands.has(name)) {
+        // the expression is quoted last, after the options
+        const expression = command.indexOf('"');
+        return (
+            expression === -1 ||
+            sideEffectRegex.test(command.slice(expression))
+        );
+    }
+    return changeValuesCommands.has(name);
+}
+
+/** The varobjs of one frame, indexed for lookups */
+interface FrameVars {
+    threadId: number;
+    /** The stop of the program the frame was last used in */
+    stop: number;
+    /** By varname, in the order they were added */
+    byName: Map<string, VarObjType>;
+    /** By varType, then by expression */
+    byExpression: Map<string, Map<string, VarObjType>>;
+    /** Children gdb created when listing them, by varname of their parent */
+    listed: Map<string, number>;
+}
+
+/** Varobjs kept by default before the least recently used frames go */
+export const DEFAULT_VAROBJ_LIMIT = 5000;
+
 export class VarManager {
-    protected readonly variableMap: Map<string, VarObjType[]> = new Map<
-        string,
-        VarObjType[]
-    >();
+    // the least recently used frame first, a frame moves last when used
+    protected readonly variableMap = new Map<string, FrameVars>();
+    // all the varobjs, varnames are unique in gdb
+    protected readonly varobjs = new Map<string, VarObjType>();
+    // the children gdb created for the varobjs
+    protected children = 0;
+    // the update of the varobjs since the program last stopped or changed
+    protected snapshot?: Promise<void>;
+    // ticks each time the program stops
+    protected stop = 0;
+    /** -var-update commands sent for all the varobjs */
+    public updates = 0;
+    /** Varobjs deleted to stay within limit */
+    public evicted = 0;
+    /**
+     * Most varobjs kept in gdb, beyond which the varobjs of the least
+     * recently used frames are deleted. The frames used since the program
+     * last stopped are kept, requests may be using them. 0 for no limit.
+     */
+    public limit = DEFAULT_VAROBJ_LIMIT;
 
     constructor(protected gdb: GDBBackend) {
         this.gdb = gdb;
     }
 
-    public getKey(frameId: number, threadId: number, depth: number): string {
-        return `frame${frameId}_thread${threadId}_depth${depth}`;
+    /**
+     * The key of the varobjs of a frame of a thread. frameKey identifies
+     * the frame for as long as it is live, whatever its level.
+     */
+    public getKey(threadId: number, frameKey: string): string {
+        return `${threadId}:${frameKey}`;
+    }
+
+    /** Varobjs in gdb: those the adapter created and the children listed */
+    get size(): number {
+        return this.varobjs.size + this.children;
+    }
+
+    /** Frames that have varobjs */
+    get frames(): number {
+        return this.variableMap.size;
+    }
+
+    protected getFrameVars(
+        threadId: number,
+        frameKey: string
+    ): FrameVars | undefined {
+        const key = this.getKey(threadId, frameKey);
+        const frameVars = this.variableMap.get(key);
+        if (frameVars) {
+            this.touch(key, frameVars);
+        }
+        return frameVars;
+    }
+
+    /** Make frameVars the most recently used frame */
+    protected touch(key: string, frameVars: FrameVars) {
+        this.variableMap.delete(key);
+        this.variableMap.set(key, frameVars);
+        frameVars.stop = this.stop;
+    }
+
+    /**
+     * The program stopped. The frames used before can be evicted, the
+     * requests of the previous stop are done with them.
+     */
+    public programStopped() {
+        this.stop++;
     }
 
     public getVars(
-        frameId: number,
         threadId: number,
-        depth: number
+        frameKey: string
     ): VarObjType[] | undefined {
-        return this.variableMap.get(this.getKey(frameId, threadId, depth));
+        const frameVars = this.getFrameVars(threadId, frameKey);
+        return frameVars && Array.from(frameVars.byName.values());
     }
 
     public getVar(
-        frameId: number,
         threadId: number,
-        depth: number,
+        frameKey: string,
         expression: string,
         type?: string
     ): VarObjType | undefined {
-        const vars = this.getVars(frameId, threadId, depth);
-        if (vars) {
-            for (const varobj of vars) {
-                if (varobj.expression === expression) {
-                    if (type !== 'registers') {
-                        type = 'local';
-                    }
-                    if (type === varobj.varType) {
-                        return varobj;
-                    }
-                }
-            }
-        }
-        return;
+        return this.getFrameVars(threadId, frameKey)
+            ?.byExpression.get(type === 'registers' ? type : 'local')
+            ?.get(expression);
     }
 
     public getVarByName(
-        frameId: number,
         threadId: number,
-        depth: number,
+        frameKey: string,
         varname: string
     ): VarObjType | undefined {
-        const vars = this.getVars(frameId, threadId, depth);
-        if (vars) {
-            for (const varobj of vars) {
-                if (varobj.varname === varname) {
-                    return varobj;
-                }
-            }
-        }
-        return;
+        return this.getFrameVars(threadId, frameKey)?.byName.get(varname);
     }
 
     public addVar(
-        frameId: number,
         threadId: number,
-        depth: number,
+        frameKey: string,
         expression: string,
         isVar: boolean,
         isChild: boolean,
         varCreateResponse: MIVarCreateResponse,
         type?: string
     ): VarObjType {
-        let vars = this.variableMap.get(this.getKey(frameId, threadId, depth));
-        if (!vars) {
-            vars = [];
-            this.variableMap.set(this.getKey(frameId, threadId, depth), vars);
-        }
+        const key = this.getKey(threadId, frameKey);
+        const frameVars = this.variableMap.get(key) ?? {
+            threadId,
+            stop: this.stop,
+            byName: new Map(),
+            byExpression: new Map(),
+            listed: new Map(),
+        };
+        this.touch(key, frameVars);
         const varobj: VarObjType = {
             varname: varCreateResponse.name,
             expression,
@@ -102,77 +202,232 @@ export class VarManager {
             isChild,
             varType: type ? type : 'local',
         };
-        vars.push(varobj);
+        frameVars.byName.set(varobj.varname, varobj);
+        this.varobjs.set(varobj.varname, varobj);
+        let byExpression = frameVars.byExpression.get(varobj.varType);
+        if (!byExpression) {
+            byExpression = new Map();
+            frameVars.byExpression.set(varobj.varType, byExpression);
+        }
+        byExpression.set(expression, varobj);
+        this.evict();
         return varobj;
     }
 
+    /**
+     * Count the children gdb created to list those of parent, a varobj of
+     * the frame or one of their children. Listing them again creates none.
+     */
+    public addChildren(
+        threadId: number,
+        frameKey: string,
+        parent: string,
+        count: number
+    ) {
+        const frameVars = this.getFrameVars(threadId, frameKey);
+        const listed = frameVars?.listed.get(parent) ?? 0;
+        if (!frameVars || count <= listed) {
+            return;
+        }
+        frameVars.listed.set(parent, count);
+        this.children += count - listed;
+        this.evict();
+    }
+
     public async removeVar(
-        frameId: number,
         threadId: number,
-        depth: number,
+        frameKey: string,
         varname: string
     ): Promise<void> {
-        let deleteme: VarObjType | undefined;
-        const vars = this.variableMap.get(
-            this.getKey(frameId, threadId, depth)
+        const key = this.getKey(threadId, frameKey);
+        const frameVars = this.variableMap.get(key);
+        const deleteme = frameVars?.byName.get(varname);
+        if (!frameVars || !deleteme) {
+            return;
+        }
+        // forget it before awaiting gdb, so that it cannot be found anymore
+        this.forget(frameVars, deleteme);
+        if (!frameVars.byName.size) {
+            this.variableMap.delete(key);
+        }
+        // gdb deletes the children with their parent
+        await sendVarDelete(this.gdb, { varname: deleteme.varname });
+    }
+
+    /** Forget varobj and its children, without deleting them in gdb */
+    protected forget(frameVars: FrameVars, varobj: VarObjType) {
+        frameVars.byName.delete(varobj.varname);
+        this.varobjs.delete(varobj.varname);
+        const byExpression = frameVars.byExpression.get(varobj.varType);
+        // unless a newer varobj of the expression replaced it
+        if (byExpression?.get(varobj.expression) === varobj) {
+            byExpression.delete(varobj.expression);
+        }
+        // gdb deletes the children it listed with their ancestor
+        const prefix = varobj.varname + '.';
+        for (const [parent, count] of Array.from(frameVars.listed)) {
+            if (parent === varobj.varname || parent.startsWith(prefix)) {
+                frameVars.listed.delete(parent);
+                this.children -= count;
+            }
+        }
+        for (const child of varobj.children) {
+            this.forget(frameVars, child);
+        }
+    }
+
+    /** Children gdb created for the varobjs of a frame */
+    protected listedChildren(frameVars: FrameVars): number {
+        let count = 0;
+        for (const listed of frameVars.listed.values()) {
+            count += listed;
+        }
+        return count;
+    }
+
+    /**
+     * Delete the varobjs of a frame, one -var-delete per tree of varobjs,
+     * all sent at once.
+     */
+    protected removeFrame(key: string): Promise<void> {
+        const frameVars = this.variableMap.get(key);
+        if (!frameVars) {
+            return Promise.resolve();
+        }
+        this.variableMap.delete(key);
+        const roots = new Set(frameVars.byName.values());
+        for (const varobj of frameVars.byName.values()) {
+            for (const child of varobj.children) {
+                roots.delete(child);
+            }
+        }
+        for (const varobj of frameVars.byName.values()) {
+            this.varobjs.delete(varobj.varname);
+        }
+        this.children -= this.listedChildren(frameVars);
+        return Promise.all(
+            Array.from(roots, (varobj) =>
+                sendVarDelete(this.gdb, { varname: varobj.varname })
+            )
+        ).then(() => undefined);
+    }
+
+    /**
+     * Delete the varobjs of the least recently used frames until at most
+     * limit varobjs are left, or only those used since the last stop.
+     */
+    protected evict() {
+        const deletes: Promise<void>[] = [];
+        for (const [key, frameVars] of this.variableMap) {
+            // the frames after the first one of this stop are of it too
+            if (
+                !this.limit ||
+                this.size <= this.limit ||
+                frameVars.stop === this.stop
+            ) {
+                break;
+            }
+            this.evicted +=
+                frameVars.byName.size + this.listedChildren(frameVars);
+            deletes.push(this.removeFrame(key));
+        }
+        // nothing waits for the eviction, the varobjs are forgotten already
+        Promise.all(deletes).catch((err) =>
+            logger.warn(`Could not delete evicted varobjs: ${err}`)
         );
-        if (vars) {
-            for (const varobj of vars) {
-                if (varobj.varname === varname) {
-                    deleteme = varobj;
-                    break;
-                }
+    }
+
+    /** Delete the varobjs of a thread that exited */
+    public removeThread(threadId: number): Promise<void> {
+        const deletes: Promise<void>[] = [];
+        for (const [key, frameVars] of Array.from(this.variableMap)) {
+            if (frameVars.threadId === threadId) {
+                deletes.push(this.removeFrame(key));
             }
-            if (deleteme) {
-                await sendVarDelete(this.gdb, { varname: deleteme.varname });
-                vars.splice(vars.indexOf(deleteme), 1);
-                for (const child of deleteme.children) {
-                    await this.removeVar(
-                        frameId,
-                        threadId,
-                        depth,
-                        child.varname
-                    );
+        }
+        return Promise.all(deletes).then(() => undefined);
+    }
+
+    /**
+     * Forget the last update, the values of the program may have changed.
+     */
+    public invalidate() {
+        this.snapshot = undefined;
+    }
+
+    /**
+     * Update the values and the scope of all the varobjs with one
+     * -var-update, the first time it is called after the program stopped
+     * or changed. The varobjs created after that are up to date already.
+     */
+    public refresh(): Promise<void> {
+        if (this.snapshot) {
+            return this.snapshot;
+        }
+        if (!this.varobjs.size) {
+            this.snapshot = Promise.resolve();
+            return this.snapshot;
+        }
+        this.updates++;
+        const snapshot = sendVarUpdate(this.gdb, {}).then(
+            (vup) => this.applyChanges(vup),
+            (err) => {
+                if (this.snapshot === snapshot) {
+                    this.snapshot = undefined;
                 }
+                throw err;
+            }
+        );
+        this.snapshot = snapshot;
+        return snapshot;
+    }
+
+    protected applyChanges(vup: MIVarUpdateResponse) {
+        for (const change of vup.changelist) {
+            // the changes of untracked children are not needed
+            const varobj = this.varobjs.get(change.name);
+            if (!varobj) {
+                continue;
+            }
+            if (change.in_scope === 'true') {
+                varobj.value = change.value;
+                varobj.outOfScope = false;
+            } else {
+                varobj.outOfScope = true;
             }
         }
     }
 
+    /**
+     * Bring varobj up to date, or create it again if it went out of scope.
+     *
+     * @returns varobj, or the one that replaced it
+     */
     public async updateVar(
         frameId: number,
         threadId: number,
-        depth: number,
+        frameKey: string,
         varobj: VarObjType
     ): Promise<VarObjType> {
-        let returnVar = varobj;
-        const vup = await sendVarUpdate(this.gdb, { name: varobj.varname });
-        const update = vup.changelist[0];
-        if (update) {
-            if (update.in_scope === 'true') {
-                if (update.name === varobj.varname) {
-                    // don't update the parent value to a child's value
-                    varobj.value = update.value;
-                }
-            } else {
-                this.removeVar(frameId, threadId, depth, varobj.varname);
-                await sendVarDelete(this.gdb, { varname: varobj.varname });
-                const createResponse = await sendVarCreate(this.gdb, {
-                    frame: 'current',
-                    expression: varobj.expression,
-                    frameId: frameId,
-                    threadId: threadId,
-                });
-                returnVar = this.addVar(
-                    frameId,
-                    threadId,
-                    depth,
-                    varobj.expression,
-                    varobj.isVar,
-                    varobj.isChild,
-                    createResponse
-                );
-            }
+        await this.refresh();
+        if (!varobj.outOfScope) {
+            return varobj;
         }
-        return Promise.resolve(returnVar);
+        await this.removeVar(threadId, frameKey, varobj.varname);
+        const createResponse = await sendVarCreate(this.gdb, {
+            frame: 'current',
+            expression: varobj.expression,
+            frameId: frameId,
+            threadId: threadId,
+        });
+        return this.addVar(
+            threadId,
+            frameKey,
+            varobj.expression,
+            varobj.isVar,
+            varobj.isChild,
+            createResponse,
+            varobj.varType
+        );
     }
 }